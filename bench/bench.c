@@ -0,0 +1,490 @@
+#include "word.h"
+#include "random.h"
+#include "sentence.h"
+#include "config.h"
+#include "config_file.h"
+#include "game_metrics.h"
+#include "session_store.h"
+#include "window.h"
+#include "glyph_atlas.h"
+#include "text_batch.h"
+#include "text_layout.h"
+#include "sentence_view.h"
+#include "log.h"
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Microbenchmarks of the load, sample, layout and render paths. Every
+// benchmark is run at least BENCH_MIN_RUNS times and for BENCH_MIN_SECONDS,
+// and the fastest run is reported, which is the least noisy on a busy machine.
+
+#define BENCH_MIN_RUNS    5
+#define BENCH_MAX_RUNS    1000
+#define BENCH_MIN_SECONDS 0.5
+#define BENCH_MAX_RESULTS 16
+
+typedef struct {
+    const char* name;
+    double ns_per_op;
+    uint64_t ops;
+} BenchResult;
+
+typedef struct {
+    const char* dictionary;
+    const char* font;
+    const char* output;
+    const char* baseline;
+    double threshold;
+    int dictionary_words;
+    int history_rounds;
+} BenchOptions;
+
+// Files and state shared by the benchmarks.
+typedef struct {
+    char dir[256];
+    char dictionary[512];
+    char index[512];
+    char sessions[512];
+    char config[512];
+    const char* font;
+
+    Word word;
+    Random random;
+    Sentence sentence;
+
+    Window window;
+    TTF_Font* ttf;
+    GlyphAtlas atlas;
+    TextBatch batch;
+    TextLayout layout;
+    SDL_FPoint* positions;
+    SDL_Color* colors;
+} BenchContext;
+
+// Runs one batch of work and reports how many operations it did.
+typedef void (*BenchFunc)(BenchContext* context, uint64_t* ops);
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static int result_count = 0;
+
+static double nowSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static void benchRun(const char* name, BenchFunc func, BenchContext* context) {
+    double best = -1.0;
+    uint64_t total_ops = 0;
+    double start_all = nowSeconds();
+
+    for (int runs = 0; runs < BENCH_MAX_RUNS; runs++) {
+        if (runs >= BENCH_MIN_RUNS && nowSeconds() - start_all >= BENCH_MIN_SECONDS) {
+            break;
+        }
+
+        uint64_t ops = 0;
+        double start = nowSeconds();
+        func(context, &ops);
+        double elapsed = nowSeconds() - start;
+        if (ops == 0) {
+            continue;
+        }
+
+        double ns_per_op = elapsed * 1e9 / (double)ops;
+        if (best < 0.0 || ns_per_op < best) {
+            best = ns_per_op;
+        }
+        total_ops += ops;
+    }
+
+    if (best < 0.0 || result_count == BENCH_MAX_RESULTS) {
+        fprintf(stderr, "%s: no result\n", name);
+        return;
+    }
+    results[result_count++] = (BenchResult){name, best, total_ops};
+    printf("%-24s %14.1f ns/op\n", name, best);
+}
+
+static void benchWordInitCold(BenchContext* context, uint64_t* ops) {
+    remove(context->index);
+    Word_init(&context->word, context->dictionary, context->index);
+    Word_destroy(&context->word);
+    *ops = 1;
+}
+
+static void benchWordInitCached(BenchContext* context, uint64_t* ops) {
+    Word_init(&context->word, context->dictionary, context->index);
+    Word_destroy(&context->word);
+    *ops = 1;
+}
+
+static void benchWordGetSentence(BenchContext* context, uint64_t* ops) {
+    for (int i = 0; i < 1000; i++) {
+        Word_getSentence(&context->word, &context->random, 25, &context->sentence);
+    }
+    *ops = 1000;
+}
+
+static void benchConfigInit(BenchContext* context, uint64_t* ops) {
+    (void)context;
+    for (int i = 0; i < 100; i++) {
+        Config config;
+        Config_init(&config);
+        // Strings read from the file are the only allocations.
+        free(config.dictionary.value.str_value);
+        free(config.font.value.str_value);
+    }
+    *ops = 100;
+}
+
+static void benchGameMetricsLoad(BenchContext* context, uint64_t* ops) {
+    GameMetrics metrics;
+    GameMetrics_init(&metrics);
+    GameMetrics_load(&metrics, context->sessions, NULL);
+    *ops = metrics.speed.count;
+    GameMetrics_free(&metrics);
+}
+
+// Same work as a game frame with only the sentence: the game's text path
+// plus the clear and the present.
+static void renderFrame(BenchContext* context) {
+    Window_setColor(&context->window, (SDL_Color){0, 0, 0, 255});
+    Window_clear(&context->window);
+    SentenceView_render(&context->layout, context->positions, &context->batch, &context->atlas,
+                        context->window.renderer, context->sentence.data, context->sentence.data, context->colors,
+                        context->sentence.length, context->window.width);
+    Window_render(&context->window);
+}
+
+static void benchRenderText(BenchContext* context, uint64_t* ops) {
+    for (int i = 0; i < 100; i++) {
+        renderFrame(context);
+    }
+    *ops = 100;
+}
+
+static void benchRenderTextRelayout(BenchContext* context, uint64_t* ops) {
+    for (int i = 0; i < 100; i++) {
+        TextLayout_invalidate(&context->layout);
+        renderFrame(context);
+    }
+    *ops = 100;
+}
+
+// Random lowercase words of 1 to 12 letters, the same for every run.
+static bool writeDictionary(const char* file_path, int words) {
+    FILE* file = fopen(file_path, "w");
+    if (!file) {
+        perror("Failed to create dictionary");
+        return false;
+    }
+
+    Random random;
+    Random_init(&random, 1);
+    char word[16];
+    for (int i = 0; i < words; i++) {
+        int length = 1 + (int)Random_bounded(&random, 12);
+        for (int j = 0; j < length; j++) {
+            word[j] = (char)('a' + Random_bounded(&random, 26));
+        }
+        word[length] = '\n';
+        fwrite(word, 1, (size_t)length + 1, file);
+    }
+    return fclose(file) == 0;
+}
+
+static bool writeHistory(const char* file_path, int rounds) {
+    remove(file_path);
+
+    Random random;
+    Random_init(&random, 2);
+    SessionRecord batch[1024];
+    for (int written = 0; written < rounds; written += 1024) {
+        int count = rounds - written < 1024 ? rounds - written : 1024;
+        for (int i = 0; i < count; i++) {
+            batch[i] = (SessionRecord){
+                .timestamp = written + i,
+                .wpm = 20.0 + Random_bounded(&random, 8000) / 100.0,
+                .accuracy = 80.0 + Random_bounded(&random, 2000) / 100.0,
+                .duration = 30.0,
+                .seed = 0,
+                .round = (uint32_t)(written + i),
+                .word_count = 25,
+            };
+        }
+        if (!SessionStore_appendBatch(file_path, batch, (size_t)count)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool writeConfig(BenchContext* context) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/config", context->dir);
+    setenv("XDG_CONFIG_HOME", path, 1);
+    setenv("XDG_DATA_HOME", context->dir, 1);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/config/type-trainer", context->dir);
+    mkdir(path, 0755);
+    snprintf(context->config, sizeof(context->config), "%s/config/type-trainer/config.txt", context->dir);
+
+    FILE* file = fopen(context->config, "w");
+    if (!file) {
+        perror("Failed to create config");
+        return false;
+    }
+    fprintf(file,
+            "# Benchmark config\n"
+            "dictionary=%s\n"
+            "font=%s\n"
+            "font_size=28\n"
+            "total_words=25\n"
+            "min_word_length=1\n"
+            "max_word_length=9\n"
+            "advance_on_failure=false\n"
+            "seed=1\n"
+            "vsync=false\n"
+            "color_background=0,0,0,255\n"
+            "color_text_default=210,220,240,255\n"
+            "color_text_error=150,0,30,255\n"
+            "color_text_typed=130,100,100,255\n",
+            context->dictionary, context->font);
+    return fclose(file) == 0;
+}
+
+// Offscreen window with the font atlas, false if there is no video or font.
+static bool initRenderer(BenchContext* context) {
+    if (!SDL_GetHint(SDL_HINT_VIDEO_DRIVER)) {
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    }
+    if (!SDL_Init(SDL_INIT_VIDEO) || !TTF_Init()) {
+        fprintf(stderr, "Skipping render benchmarks: %s\n", SDL_GetError());
+        return false;
+    }
+    if (Window_init(&context->window) != 0) {
+        fprintf(stderr, "Skipping render benchmarks: %s\n", SDL_GetError());
+        return false;
+    }
+    context->ttf = TTF_OpenFont(context->font, 28);
+    if (!context->ttf || !GlyphAtlas_init(&context->atlas, context->window.renderer, context->ttf)) {
+        fprintf(stderr, "Skipping render benchmarks, can't load %s: %s\n", context->font, SDL_GetError());
+        if (context->ttf) {
+            TTF_CloseFont(context->ttf);
+        }
+        Window_destroy(&context->window);
+        return false;
+    }
+    context->positions = malloc(sizeof(SDL_FPoint) * (context->sentence.length + 1));
+    context->colors = malloc(sizeof(SDL_Color) * (context->sentence.length + 1));
+    if (!context->positions || !context->colors) {
+        fprintf(stderr, "Memory allocation for layout failed.\n");
+        free(context->positions);
+        free(context->colors);
+        GlyphAtlas_destroy(&context->atlas);
+        TTF_CloseFont(context->ttf);
+        Window_destroy(&context->window);
+        return false;
+    }
+    for (size_t i = 0; i <= context->sentence.length; i++) {
+        context->colors[i] = (SDL_Color){210, 220, 240, 255};
+    }
+    TextBatch_init(&context->batch);
+    TextLayout_init(&context->layout);
+    return true;
+}
+
+static void destroyRenderer(BenchContext* context) {
+    TextLayout_destroy(&context->layout);
+    free(context->positions);
+    free(context->colors);
+    TextBatch_destroy(&context->batch);
+    GlyphAtlas_destroy(&context->atlas);
+    TTF_CloseFont(context->ttf);
+    Window_destroy(&context->window);
+}
+
+static bool writeResults(const char* file_path) {
+    FILE* file = fopen(file_path, "w");
+    if (!file) {
+        perror("Failed to write benchmark results");
+        return false;
+    }
+    fprintf(file, "{\n  \"benchmarks\": [\n");
+    for (int i = 0; i < result_count; i++) {
+        fprintf(file, "    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"ops\": %llu}%s\n", results[i].name,
+                results[i].ns_per_op, (unsigned long long)results[i].ops, i + 1 < result_count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+// Compare against a file written by writeResults. Returns the number of
+// benchmarks slower than the baseline by more than threshold. Benchmarks
+// missing from the baseline and baseline entries that didn't run, like the
+// render benchmarks without a video driver, are only reported.
+static int compareBaseline(const char* file_path, double threshold) {
+    FILE* file = fopen(file_path, "r");
+    if (!file) {
+        fprintf(stderr, "No baseline at %s, nothing to compare\n", file_path);
+        return 0;
+    }
+
+    int regressions = 0;
+    bool compared[BENCH_MAX_RESULTS] = {false};
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char name[64];
+        double baseline;
+        if (sscanf(line, " {\"name\": \"%63[^\"]\", \"ns_per_op\": %lf", name, &baseline) != 2 || baseline <= 0.0) {
+            continue;
+        }
+        bool found = false;
+        for (int i = 0; i < result_count; i++) {
+            if (strcmp(results[i].name, name) != 0) {
+                continue;
+            }
+            double change = results[i].ns_per_op / baseline - 1.0;
+            bool regressed = change > threshold;
+            printf("%-24s %+7.1f %%%s\n", name, change * 100.0, regressed ? "  REGRESSION" : "");
+            regressions += regressed;
+            compared[i] = true;
+            found = true;
+        }
+        if (!found) {
+            printf("%-24s    not run\n", name);
+        }
+    }
+    fclose(file);
+
+    for (int i = 0; i < result_count; i++) {
+        if (!compared[i]) {
+            printf("%-24s    no baseline, run make bench-baseline\n", results[i].name);
+        }
+    }
+    return regressions;
+}
+
+static bool parseOptions(BenchOptions* options, int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = argv[i + 1];
+        if (strcmp(arg, "--dictionary") == 0) {
+            options->dictionary = value;
+        } else if (strcmp(arg, "--font") == 0) {
+            options->font = value;
+        } else if (strcmp(arg, "--output") == 0) {
+            options->output = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            options->baseline = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            options->threshold = atof(value);
+        } else if (strcmp(arg, "--words") == 0) {
+            options->dictionary_words = atoi(value);
+        } else if (strcmp(arg, "--history") == 0) {
+            options->history_rounds = atoi(value);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+    }
+    return argc % 2 == 1;
+}
+
+static void removeFiles(BenchContext* context) {
+    char path[512];
+    remove(context->index);
+    remove(context->sessions);
+    remove(context->config);
+    snprintf(path, sizeof(path), "%s/dictionary", context->dir);
+    remove(path);
+    snprintf(path, sizeof(path), "%s/config/type-trainer", context->dir);
+    rmdir(path);
+    snprintf(path, sizeof(path), "%s/config", context->dir);
+    rmdir(path);
+    rmdir(context->dir);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options = {
+        .dictionary = NULL,
+        .font = "/usr/share/fonts/gnu-free/FreeMono.otf",
+        .output = "bench.json",
+        .baseline = NULL,
+        .threshold = 0.25,
+        .dictionary_words = 500000,
+        .history_rounds = 200000,
+    };
+    if (!parseOptions(&options, argc, argv)) {
+        fprintf(stderr, "Usage: bench [--output file] [--baseline file] [--threshold fraction] "
+                        "[--dictionary path] [--words n] [--font path] [--history rounds]\n");
+        return 1;
+    }
+
+    static BenchContext context;
+    const char* tmp = getenv("TMPDIR");
+    snprintf(context.dir, sizeof(context.dir), "%s/type-trainer-bench-XXXXXX", tmp && *tmp ? tmp : "/tmp");
+    if (!mkdtemp(context.dir)) {
+        perror("Failed to create benchmark directory");
+        return 1;
+    }
+    if (options.dictionary) {
+        snprintf(context.dictionary, sizeof(context.dictionary), "%s", options.dictionary);
+    } else {
+        snprintf(context.dictionary, sizeof(context.dictionary), "%s/dictionary", context.dir);
+    }
+    snprintf(context.index, sizeof(context.index), "%s/dictionary.idx", context.dir);
+    snprintf(context.sessions, sizeof(context.sessions), "%s/sessions", context.dir);
+    context.font = options.font;
+
+    bool ok = (options.dictionary || writeDictionary(context.dictionary, options.dictionary_words)) &&
+              writeHistory(context.sessions, options.history_rounds) &&
+              writeConfig(&context);
+    ConfigFileResolvePaths();
+    Log_init();
+
+    if (ok) {
+        benchRun("word_init_cold", benchWordInitCold, &context);
+        benchRun("word_init_cached", benchWordInitCached, &context);
+
+        Word_init(&context.word, context.dictionary, context.index);
+        Random_init(&context.random, 1);
+        Sentence_init(&context.sentence);
+        benchRun("word_get_sentence", benchWordGetSentence, &context);
+
+        benchRun("config_init", benchConfigInit, &context);
+        benchRun("game_metrics_load_round", benchGameMetricsLoad, &context);
+
+        if (initRenderer(&context)) {
+            benchRun("render_text", benchRenderText, &context);
+            benchRun("render_text_relayout", benchRenderTextRelayout, &context);
+            destroyRenderer(&context);
+        }
+        Sentence_destroy(&context.sentence);
+        Word_destroy(&context.word);
+    }
+
+    Log_quit();
+    removeFiles(&context);
+    SDL_Quit();
+    if (!ok || !writeResults(options.output)) {
+        return 1;
+    }
+    printf("Results written to %s\n", options.output);
+
+    if (options.baseline && compareBaseline(options.baseline, options.threshold) > 0) {
+        fprintf(stderr, "Benchmarks regressed by more than %.0f %% against %s\n", options.threshold * 100.0, options.baseline);
+        return 1;
+    }
+    return 0;
+}
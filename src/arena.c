@@ -0,0 +1,50 @@
+#include "arena.h"
+
+#include <stdalign.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_ALIGN alignof(max_align_t)
+
+void Arena_init(Arena* arena) {
+    arena->data = NULL;
+    arena->used = 0;
+    arena->capacity = 0;
+}
+
+bool Arena_reset(Arena* arena, size_t capacity) {
+    arena->used = 0;
+    if (capacity <= arena->capacity) {
+        return true;
+    }
+
+    // Nothing is allocated after a reset, so the old contents can go.
+    free(arena->data);
+    arena->data = malloc(capacity);
+    if (!arena->data) {
+        fprintf(stderr, "Memory allocation for arena failed.\n");
+        arena->capacity = 0;
+        return false;
+    }
+    arena->capacity = capacity;
+    return true;
+}
+
+size_t Arena_size(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+void* Arena_alloc(Arena* arena, size_t size) {
+    size_t aligned = Arena_size(size);
+    if (aligned > arena->capacity - arena->used) {
+        return NULL;
+    }
+    void* memory = arena->data + arena->used;
+    arena->used += aligned;
+    return memory;
+}
+
+void Arena_destroy(Arena* arena) {
+    free(arena->data);
+    Arena_init(arena);
+}
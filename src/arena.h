@@ -0,0 +1,32 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bump allocator for data that lives exactly as long as a round. Everything
+// is freed at once by resetting it, and the block is only reallocated when a
+// reset asks for more room than it has.
+typedef struct {
+    unsigned char* data;
+    size_t used;
+    size_t capacity;
+} Arena;
+
+// Initialize an empty arena.
+void Arena_init(Arena* arena);
+
+// Free every allocation and make room for at least capacity bytes. Returns
+// false if the block couldn't grow.
+bool Arena_reset(Arena* arena, size_t capacity);
+
+// Bytes an allocation of size takes from the arena, including alignment.
+size_t Arena_size(size_t size);
+
+// Allocate size bytes aligned for any type, NULL if the arena is full.
+void* Arena_alloc(Arena* arena, size_t size);
+
+// Free the block.
+void Arena_destroy(Arena* arena);
+
+#endif
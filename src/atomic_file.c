@@ -0,0 +1,49 @@
+#include "atomic_file.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+bool AtomicFile_open(AtomicFile* atomic, const char* file_path) {
+    snprintf(atomic->path, sizeof(atomic->path), "%s", file_path);
+    snprintf(atomic->temp_path, sizeof(atomic->temp_path), "%s.tmp", file_path);
+    atomic->file = fopen(atomic->temp_path, "wb");
+    return atomic->file != NULL;
+}
+
+bool AtomicFile_sync(FILE* file) {
+    if (fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool AtomicFile_replace(const char* from, const char* to) {
+#ifdef _WIN32
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from, to) == 0;
+#endif
+}
+
+bool AtomicFile_commit(AtomicFile* atomic, bool ok) {
+    ok = ok && AtomicFile_sync(atomic->file);
+    if (fclose(atomic->file) != 0) {
+        ok = false;
+    }
+    atomic->file = NULL;
+
+    // Replace the old file only once the new one is complete.
+    if (!ok || !AtomicFile_replace(atomic->temp_path, atomic->path)) {
+        remove(atomic->temp_path);
+        return false;
+    }
+    return true;
+}
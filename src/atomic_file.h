@@ -0,0 +1,29 @@
+#ifndef ATOMIC_FILE_H
+#define ATOMIC_FILE_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Replaces a file only once its new contents are complete and on disk, so a
+// crash leaves either the old or the new file and never a truncated one.
+typedef struct {
+    FILE* file;
+    char path[512];
+    char temp_path[512];
+} AtomicFile;
+
+// Open a temporary file next to file_path for writing.
+bool AtomicFile_open(AtomicFile* atomic, const char* file_path);
+
+// Flush and sync the temporary file and rename it over the target if ok,
+// otherwise discard it. Returns whether the target was replaced.
+bool AtomicFile_commit(AtomicFile* atomic, bool ok);
+
+// Flush the stream and sync it to disk.
+bool AtomicFile_sync(FILE* file);
+
+// Rename from over to, replacing to if it exists. Plain rename can't do
+// that on Windows.
+bool AtomicFile_replace(const char* from, const char* to);
+
+#endif
@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
 
 static void modifyItemString(ConfigItem* item, const char* value) {
     item->value.str_value = malloc(strlen(value) + 1);
@@ -24,6 +25,12 @@ static void modifyItemInt(ConfigItem* item, int value) {
     item->is_set = true;
 }
 
+static void modifyItemUint64(ConfigItem* item, uint64_t value) {
+    item->value.uint64_value = value;
+    item->type = CONFIG_TYPE_UINT64;
+    item->is_set = true;
+}
+
 static void modifyItemBoolean(ConfigItem* item, bool value) {
     item->value.boolean_value = value;
     item->type = CONFIG_TYPE_BOOLEAN;
@@ -42,11 +49,17 @@ static const char* configNameTypeToString(ConfigNameType type) {
         case CONFIG_NAME_FONT: return "font";
         case CONFIG_NAME_FONT_SIZE: return "font_size";
         case CONFIG_NAME_TOTAL_WORDS: return "total_words";
+        case CONFIG_NAME_MIN_WORD_LENGTH: return "min_word_length";
+        case CONFIG_NAME_MAX_WORD_LENGTH: return "max_word_length";
         case CONFIG_NAME_ADVANCE_ON_FAILURE: return "advance_on_failure";
+        case CONFIG_NAME_SEED: return "seed";
+        case CONFIG_NAME_VSYNC: return "vsync";
         case CONFIG_NAME_COLOR_BACKGROUND: return "color_background";
         case CONFIG_NAME_COLOR_TEXT_DEFAULT: return "color_text_default";
         case CONFIG_NAME_COLOR_TEXT_ERROR: return "color_text_error";
         case CONFIG_NAME_COLOR_TEXT_TYPED: return "color_text_typed";
+        case CONFIG_NAME_TRACE_FILE: return "trace_file";
+        case CONFIG_NAME_TEXTURE_BUDGET_MB: return "texture_budget_mb";
     }
     return "";
 }
@@ -56,11 +69,17 @@ void Config_useDefault(Config* config) {
     Config_useDefaultForItem(config, &config->font);
     Config_useDefaultForItem(config, &config->font_size);
     Config_useDefaultForItem(config, &config->total_words);
+    Config_useDefaultForItem(config, &config->min_word_length);
+    Config_useDefaultForItem(config, &config->max_word_length);
     Config_useDefaultForItem(config, &config->advance_on_failure);
+    Config_useDefaultForItem(config, &config->seed);
+    Config_useDefaultForItem(config, &config->vsync);
     Config_useDefaultForItem(config, &config->color_background);
     Config_useDefaultForItem(config, &config->color_text_default);
     Config_useDefaultForItem(config, &config->color_text_error);
     Config_useDefaultForItem(config, &config->color_text_typed);
+    Config_useDefaultForItem(config, &config->trace_file);
+    Config_useDefaultForItem(config, &config->texture_budget_mb);
 }
 
 void Config_useDefaultForItem(Config* config, ConfigItem* configItem) {
@@ -93,11 +112,31 @@ void Config_useDefaultForItem(Config* config, ConfigItem* configItem) {
             config->total_words.type = CONFIG_TYPE_INT;
             config->total_words.is_set = true;
             break;
+        case CONFIG_NAME_MIN_WORD_LENGTH:
+            config->min_word_length.value.int_value = 1;
+            config->min_word_length.type = CONFIG_TYPE_INT;
+            config->min_word_length.is_set = true;
+            break;
+        case CONFIG_NAME_MAX_WORD_LENGTH:
+            config->max_word_length.value.int_value = 9;
+            config->max_word_length.type = CONFIG_TYPE_INT;
+            config->max_word_length.is_set = true;
+            break;
         case CONFIG_NAME_ADVANCE_ON_FAILURE:
             config->advance_on_failure.value.boolean_value = false;
             config->advance_on_failure.type = CONFIG_TYPE_BOOLEAN;
             config->advance_on_failure.is_set = true;
             break;
+        case CONFIG_NAME_SEED:
+            config->seed.value.uint64_value = 0;
+            config->seed.type = CONFIG_TYPE_UINT64;
+            config->seed.is_set = true;
+            break;
+        case CONFIG_NAME_VSYNC:
+            config->vsync.value.boolean_value = false;
+            config->vsync.type = CONFIG_TYPE_BOOLEAN;
+            config->vsync.is_set = true;
+            break;
         case CONFIG_NAME_COLOR_BACKGROUND:
             config->color_background.value.color_value = (SDL_Color){10, 15, 10, 255};
             config->color_background.type = CONFIG_TYPE_COLOR;
@@ -118,6 +157,18 @@ void Config_useDefaultForItem(Config* config, ConfigItem* configItem) {
             config->color_text_typed.type = CONFIG_TYPE_COLOR;
             config->color_text_typed.is_set = true;
             break;
+        case CONFIG_NAME_TRACE_FILE:
+            // Empty means tracing is off.
+            config->trace_file.value.str_value = "";
+            config->trace_file.type = CONFIG_TYPE_STRING;
+            config->trace_file.is_set = true;
+            break;
+        case CONFIG_NAME_TEXTURE_BUDGET_MB:
+            // 0 means no limit.
+            config->texture_budget_mb.value.int_value = 64;
+            config->texture_budget_mb.type = CONFIG_TYPE_INT;
+            config->texture_budget_mb.is_set = true;
+            break;
     }
 }
 
@@ -221,6 +272,23 @@ static bool loadInt(ConfigItem* item, const char* key, const char* value) {
     return false;
 }
 
+// Whole unsigned 64-bit range, so any printed seed can be passed back.
+static bool loadUint64(ConfigItem* item, const char* key, const char* value) {
+    const char* item_name = configNameTypeToString(item->name);
+    if (strcmp(key, item_name) != 0) {
+        return false;
+    }
+
+    char* end;
+    errno = 0;
+    unsigned long long parsed = strtoull(value, &end, 10);
+    if (errno != 0 || end == value || *end != '\0' || strchr(value, '-')) {
+        return false;
+    }
+    modifyItemUint64(item, (uint64_t)parsed);
+    return true;
+}
+
 static bool loadColor(ConfigItem* item, const char* key, const char* value) {
     const char* item_name = configNameTypeToString(item->name);
     if (strcmp(key, item_name) == 0) {
@@ -238,7 +306,7 @@ static bool loadColor(ConfigItem* item, const char* key, const char* value) {
 
 // Function to load config values from a file
 int Config_init(Config* config) {
-    if (!ConfigFileInit(CONFIG_FILE_DEFAULT)) {
+    if (!ConfigFileInit(CONFIG_PATH_CONFIG)) {
         return -1;
     }
 
@@ -258,10 +326,26 @@ int Config_init(Config* config) {
     config->total_words.name = CONFIG_NAME_TOTAL_WORDS;
     config->total_words.loadFunc = loadInt;
 
+    config->min_word_length.is_set = false;
+    config->min_word_length.name = CONFIG_NAME_MIN_WORD_LENGTH;
+    config->min_word_length.loadFunc = loadInt;
+
+    config->max_word_length.is_set = false;
+    config->max_word_length.name = CONFIG_NAME_MAX_WORD_LENGTH;
+    config->max_word_length.loadFunc = loadInt;
+
     config->advance_on_failure.is_set = false;
     config->advance_on_failure.name = CONFIG_NAME_ADVANCE_ON_FAILURE;
     config->advance_on_failure.loadFunc = loadBool;
 
+    config->seed.is_set = false;
+    config->seed.name = CONFIG_NAME_SEED;
+    config->seed.loadFunc = loadUint64;
+
+    config->vsync.is_set = false;
+    config->vsync.name = CONFIG_NAME_VSYNC;
+    config->vsync.loadFunc = loadBool;
+
     config->color_background.is_set = false;
     config->color_background.name = CONFIG_NAME_COLOR_BACKGROUND;
     config->color_background.loadFunc = loadColor;
@@ -278,23 +362,36 @@ int Config_init(Config* config) {
     config->color_text_typed.name = CONFIG_NAME_COLOR_TEXT_TYPED;
     config->color_text_typed.loadFunc = loadColor;
 
+    config->trace_file.is_set = false;
+    config->trace_file.name = CONFIG_NAME_TRACE_FILE;
+    config->trace_file.loadFunc = loadString;
+
+    config->texture_budget_mb.is_set = false;
+    config->texture_budget_mb.name = CONFIG_NAME_TEXTURE_BUDGET_MB;
+    config->texture_budget_mb.loadFunc = loadInt;
+
     config->items[0] = &config->dictionary;
     config->items[1] = &config->font;
     config->items[2] = &config->font_size;
     config->items[3] = &config->total_words;
-    config->items[4] = &config->advance_on_failure;
-    config->items[5] = &config->color_background;
-    config->items[6] = &config->color_text_default;
-    config->items[7] = &config->color_text_error;
-    config->items[8] = &config->color_text_typed;
+    config->items[4] = &config->min_word_length;
+    config->items[5] = &config->max_word_length;
+    config->items[6] = &config->advance_on_failure;
+    config->items[7] = &config->seed;
+    config->items[8] = &config->vsync;
+    config->items[9] = &config->color_background;
+    config->items[10] = &config->color_text_default;
+    config->items[11] = &config->color_text_error;
+    config->items[12] = &config->color_text_typed;
+    config->items[13] = &config->trace_file;
+    config->items[14] = &config->texture_budget_mb;
 
     FILE* file = NULL;
 
-    const char* configPath = ConfigFileResolve(CONFIG_FILE_DEFAULT);
+    const char* configPath = ConfigFilePath(CONFIG_PATH_CONFIG);
     if (configPath) {
         file = fopen(configPath, "r");
     }
-    free((void*)configPath);
 
     if (!file) {
         printf("Could not find config! Using default values\n");
@@ -341,3 +438,48 @@ int Config_init(Config* config) {
     return 0;
 }
 
+int Config_parseArguments(Config* config, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0) {
+            printf("Warning: Skipping invalid argument: %s\n", argv[i]);
+            continue;
+        }
+
+        char key[64], value[128];
+        const char* option = argv[i] + 2;
+        const char* equals = strchr(option, '=');
+
+        // Accept both --key=value and --key value.
+        if (equals) {
+            snprintf(key, sizeof(key), "%.*s", (int)(equals - option), option);
+            snprintf(value, sizeof(value), "%s", equals + 1);
+        }
+        else if (i + 1 < argc) {
+            snprintf(key, sizeof(key), "%s", option);
+            snprintf(value, sizeof(value), "%s", argv[++i]);
+        }
+        else {
+            printf("Missing value for argument: %s\n", argv[i]);
+            return -1;
+        }
+
+        bool found = false;
+        bool match = false;
+        for (int j = 0; j < (int)(sizeof(config->items) / sizeof(config->items[0])); j++) {
+            if (strcmp(key, configNameTypeToString(config->items[j]->name)) == 0) {
+                found = true;
+                match = config->items[j]->loadFunc(config->items[j], key, value);
+                break;
+            }
+        }
+        if (!found) {
+            printf("Unknown argument: --%s\n", key);
+            return -1;
+        }
+        if (!match) {
+            printf("Invalid value for argument: --%s\n", key);
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -4,22 +4,30 @@
 #include <SDL3/SDL_pixels.h>
 
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef enum {
     CONFIG_NAME_DICTIONARY,
     CONFIG_NAME_FONT,
     CONFIG_NAME_FONT_SIZE,
     CONFIG_NAME_TOTAL_WORDS,
+    CONFIG_NAME_MIN_WORD_LENGTH,
+    CONFIG_NAME_MAX_WORD_LENGTH,
     CONFIG_NAME_ADVANCE_ON_FAILURE,
+    CONFIG_NAME_SEED,
+    CONFIG_NAME_VSYNC,
     CONFIG_NAME_COLOR_BACKGROUND,
     CONFIG_NAME_COLOR_TEXT_DEFAULT,
     CONFIG_NAME_COLOR_TEXT_ERROR,
     CONFIG_NAME_COLOR_TEXT_TYPED,
+    CONFIG_NAME_TRACE_FILE,
+    CONFIG_NAME_TEXTURE_BUDGET_MB,
 } ConfigNameType;
 
 typedef enum {
     CONFIG_TYPE_STRING,
     CONFIG_TYPE_INT,
+    CONFIG_TYPE_UINT64,
     CONFIG_TYPE_COLOR,
     CONFIG_TYPE_BOOLEAN
 } ConfigValueType;
@@ -27,6 +35,7 @@ typedef enum {
 typedef union {
     char* str_value;
     int int_value;
+    uint64_t uint64_value;
     SDL_Color color_value;
     bool boolean_value;
 } ConfigValue;
@@ -46,18 +55,27 @@ typedef struct {
     ConfigItem font;
     ConfigItem font_size;
     ConfigItem total_words;
+    ConfigItem min_word_length;
+    ConfigItem max_word_length;
     ConfigItem advance_on_failure;
+    ConfigItem seed;
+    ConfigItem vsync;
     ConfigItem color_background;
     ConfigItem color_text_default;
     ConfigItem color_text_error;
     ConfigItem color_text_typed;
+    ConfigItem trace_file;
+    ConfigItem texture_budget_mb;
 
-    ConfigItem* items[9];
+    ConfigItem* items[15];
 } Config;
 
 // Read config file.
 int Config_init(Config* config);
 
+// Override config values with --key=value or --key value arguments.
+int Config_parseArguments(Config* config, int argc, char** argv);
+
 // Use all default configs.
 void Config_useDefault(Config* config);
 
@@ -7,6 +7,25 @@
 #include <string.h>
 #include <errno.h>
 
+#define CONFIG_PATH_MAX 512
+
+// File name below the XDG config or data directory, indexed by ConfigPath.
+static const struct {
+    const char* name;
+    bool data;
+} pathFiles[CONFIG_PATH_COUNT] = {
+    [CONFIG_PATH_CONFIG]           = {CONFIG_FILE_DEFAULT, false},
+    [CONFIG_PATH_SESSIONS]         = {CONFIG_DATA_FILE_SESSIONS, true},
+    [CONFIG_PATH_DICTIONARY_INDEX] = {CONFIG_DATA_FILE_DICTIONARY_INDEX, true},
+    [CONFIG_PATH_BIGRAMS]          = {CONFIG_DATA_FILE_BIGRAMS, true},
+    [CONFIG_PATH_PERCENTILES]      = {CONFIG_DATA_FILE_PERCENTILES, true},
+    [CONFIG_PATH_LEGACY_SPEED]     = {CONFIG_DATA_FILE_LEGACY_SPEED, true},
+    [CONFIG_PATH_LEGACY_ACCURACY]  = {CONFIG_DATA_FILE_LEGACY_ACCURACY, true},
+};
+
+static char paths[CONFIG_PATH_COUNT][CONFIG_PATH_MAX];
+static bool pathsResolved = false;
+
 // Helper function to create directories recursively
 bool create_directory(const char* path) {
     char temp[512];
@@ -32,31 +51,19 @@ bool create_directory(const char* path) {
 }
 
 bool createConfigFiles() {
-    const char* home = getenv("HOME");
-    if (!home) {
-        fprintf(stderr, "Error: HOME environment variable is not set.\n");
-        return false;
-    }
-
-    // Resolve paths
-    const char* config_file = ConfigFileResolve(CONFIG_FILE_DEFAULT);
-    const char* speed_file = ConfigFileResolve(CONFIG_DATA_FILE_SPEED);
-    const char* accuracy_file = ConfigFileResolve(CONFIG_DATA_FILE_ACCURACY);
+    const char* config_file = ConfigFilePath(CONFIG_PATH_CONFIG);
+    const char* sessions_file = ConfigFilePath(CONFIG_PATH_SESSIONS);
 
-    if (!config_file || !speed_file || !accuracy_file) {
+    if (!config_file || !sessions_file) {
         fprintf(stderr, "Error: Config file resolution failed.\n");
-        free((void*)config_file);
-        free((void*)speed_file);
-        free((void*)accuracy_file);
         return false;
     }
 
     // Extract directories from file paths
-    char config_dir[512], speed_dir[512], accuracy_dir[512];
+    char config_dir[512], sessions_dir[512];
 
-    strncpy(config_dir, config_file, sizeof(config_dir));
-    strncpy(speed_dir, speed_file, sizeof(speed_dir));
-    strncpy(accuracy_dir, accuracy_file, sizeof(accuracy_dir));
+    snprintf(config_dir, sizeof(config_dir), "%s", config_file);
+    snprintf(sessions_dir, sizeof(sessions_dir), "%s", sessions_file);
 
     char* last_slash;
 
@@ -65,36 +72,18 @@ bool createConfigFiles() {
     if (last_slash) *last_slash = '\0';
     else strcpy(config_dir, "."); // If no slash, default to current directory
 
-    // Extract directory path for speed
-    last_slash = strrchr(speed_dir, '/');
-    if (last_slash) *last_slash = '\0';
-    else strcpy(speed_dir, ".");
-
-    // Extract directory path for accuracy
-    last_slash = strrchr(accuracy_dir, '/');
+    // Extract directory path for the data files
+    last_slash = strrchr(sessions_dir, '/');
     if (last_slash) *last_slash = '\0';
-    else strcpy(accuracy_dir, ".");
+    else strcpy(sessions_dir, ".");
 
     // Ensure directories exist
     if (!create_directory(config_dir)) {
         fprintf(stderr, "Failed to create config directory: %s\n", config_dir);
-        free((void*)config_file);
-        free((void*)speed_file);
-        free((void*)accuracy_file);
-        return false;
-    }
-    if (!create_directory(speed_dir)) {
-        fprintf(stderr, "Failed to create speed directory: %s\n", speed_dir);
-        free((void*)config_file);
-        free((void*)speed_file);
-        free((void*)accuracy_file);
         return false;
     }
-    if (!create_directory(accuracy_dir)) {
-        fprintf(stderr, "Failed to create accuracy directory: %s\n", accuracy_dir);
-        free((void*)config_file);
-        free((void*)speed_file);
-        free((void*)accuracy_file);
+    if (!create_directory(sessions_dir)) {
+        fprintf(stderr, "Failed to create data directory: %s\n", sessions_dir);
         return false;
     }
 
@@ -102,50 +91,33 @@ bool createConfigFiles() {
     FILE* c_file = fopen(config_file, "a");
     if (!c_file) {
         perror("Failed to create config file");
-        free((void*)config_file);
-        free((void*)speed_file);
-        free((void*)accuracy_file);
         return false;
     }
     fclose(c_file);
 
-    FILE* s_file = fopen(speed_file, "a");
+    FILE* s_file = fopen(sessions_file, "ab");
     if (!s_file) {
-        perror("Failed to create speed file");
-        free((void*)config_file);
-        free((void*)speed_file);
-        free((void*)accuracy_file);
+        perror("Failed to create sessions file");
         return false;
     }
     fclose(s_file);
-
-    FILE* a_file = fopen(accuracy_file, "a");
-    if (!a_file) {
-        perror("Failed to create accuracy file");
-        free((void*)config_file);
-        free((void*)speed_file);
-        free((void*)accuracy_file);
-        return false;
-    }
-    fclose(a_file);
-    free((void*)config_file);
-    free((void*)speed_file);
-    free((void*)accuracy_file);
     return true;
 }
 
 
-bool ConfigFileExists(const char* file_name) {
-    const char* file_path = ConfigFileResolve(file_name);
-    FILE* file = fopen(file_path, "r");
-    free((void*)file_path);
-    return file;
+bool ConfigFileExists(ConfigPath path) {
+    const char* file_path = ConfigFilePath(path);
+    FILE* file = file_path ? fopen(file_path, "r") : NULL;
+    if (!file) {
+        return false;
+    }
+    fclose(file);
+    return true;
 }
 
-bool ConfigFileEmpty(const char* file_name) {
-    const char* resolved_file = ConfigFileResolve(file_name);
-    FILE* file = fopen(resolved_file, "r");
-    free((void*)resolved_file);
+bool ConfigFileEmpty(ConfigPath path) {
+    const char* resolved_file = ConfigFilePath(path);
+    FILE* file = resolved_file ? fopen(resolved_file, "r") : NULL;
     if (!file) {
         perror("Failed to open file");
         return false;
@@ -161,8 +133,11 @@ bool ConfigFileEmpty(const char* file_name) {
     return false; // File has content
 }
 
-bool ConfigFileInit(const char* file_name) {
-    const char* resolved_file = ConfigFileResolve(file_name);
+bool ConfigFileInit(ConfigPath path) {
+    const char* resolved_file = ConfigFilePath(path);
+    if (!resolved_file) {
+        return false;
+    }
     FILE* file = fopen(resolved_file, "r");
 
     if (!file) {
@@ -170,7 +145,6 @@ bool ConfigFileInit(const char* file_name) {
         file = fopen(resolved_file, "w");
         if (!file) {
             printf("Failed to create new config file %s", resolved_file);
-            free((void*)resolved_file);
             return false;
         }
 
@@ -180,86 +154,53 @@ bool ConfigFileInit(const char* file_name) {
         // Check if the file was created successfully by re-opening it in read mode
         file = fopen(resolved_file, "r");
         if (file) {
-            free((void*)resolved_file);
             fclose(file);
             return true;  // File created successfully
         }
         else {
-            free((void*)resolved_file);
             perror("Failed to verify new config file");
             return false;
         }
     }
     else {
-        free((void*)resolved_file);
+        fclose(file);
         return true;
     }
 }
 
-bool ConfigFileWriteInt(const char* file_name, int number) {
-    if (ConfigFileExists(file_name)) {
-        const char* resolved_file = ConfigFileResolve(file_name);
-        FILE* file = fopen(resolved_file, "w");
-        free((void*)resolved_file);
-        if (!file) {
-            perror("Failed to open file for writing");
-            return false;
-        }
-
-        // Write the number to the file.
-        if (fprintf(file, "%d", number) < 0) {
-            perror("Failed to write integer to the file");
-            fclose(file);
-            return false;
-        }
-        fclose(file);
+bool ConfigFileResolvePaths() {
+    if (pathsResolved) {
         return true;
     }
-    else {
-        return false;
-    }
-}
 
-const char* ConfigFileResolve(const char* config_file) {
     const char* home = getenv("HOME");
     const char* xdg_config_home = getenv("XDG_CONFIG_HOME");
     const char* xdg_data_home = getenv("XDG_DATA_HOME");
 
-    char* config_path = (char*)malloc(512);
-    if (!config_path) {
-        fprintf(stderr, "Error: Memory allocation failed.\n");
-        return NULL;
-    }
+    bool ok = true;
+    for (int i = 0; i < CONFIG_PATH_COUNT; i++) {
+        const char* file_name = pathFiles[i].name;
+        char* config_path = paths[i];
+        const char* xdg_home = pathFiles[i].data ? xdg_data_home : xdg_config_home;
+        const char* home_dir = pathFiles[i].data ? ".local/share" : ".config";
 
-    if (strcmp(config_file, CONFIG_FILE_DEFAULT) == 0) {
-        if (xdg_config_home && strlen(xdg_config_home) > 0) {
-            snprintf(config_path, 512, "%s/%s", xdg_config_home, config_file);
+        if (xdg_home && strlen(xdg_home) > 0) {
+            snprintf(config_path, CONFIG_PATH_MAX, "%s/%s", xdg_home, file_name);
         } else if (home) {
-            snprintf(config_path, 512, "%s/.config/%s", home, config_file);
-        } else {
-            fprintf(stderr, "Error: Neither XDG_CONFIG_HOME nor HOME is set.\n");
-            return NULL;
-        }
-    }
-    else if (strcmp(config_file, CONFIG_DATA_FILE_SPEED) == 0) {
-        if (xdg_data_home && strlen(xdg_data_home) > 0) {
-            snprintf(config_path, 512, "%s/%s", xdg_data_home, config_file);
+            snprintf(config_path, CONFIG_PATH_MAX, "%s/%s/%s", home, home_dir, file_name);
         } else {
-            snprintf(config_path, 512, "%s/.local/share/%s", home, config_file);
+            fprintf(stderr, "Error: Neither XDG_%s_HOME nor HOME is set.\n", pathFiles[i].data ? "DATA" : "CONFIG");
+            config_path[0] = '\0';
+            ok = false;
         }
     }
-    else if (strcmp(config_file, CONFIG_DATA_FILE_ACCURACY) == 0) {
-        if (xdg_data_home && strlen(xdg_data_home) > 0) {
-            snprintf(config_path, 512, "%s/%s", xdg_data_home, config_file);
-        } else {
-            snprintf(config_path, 512, "%s/.local/share/%s", home, config_file);
-        }
-    }
-    else {
-        fprintf(stderr, "Error: Unknown config file key.\n");
-        free(config_path);
+    pathsResolved = true;
+    return ok;
+}
+
+const char* ConfigFilePath(ConfigPath path) {
+    if (!pathsResolved || path < 0 || path >= CONFIG_PATH_COUNT || paths[path][0] == '\0') {
         return NULL;
     }
-
-    return config_path;
+    return paths[path];
 }
@@ -4,16 +4,36 @@
 #include <stdbool.h>
 
 #define CONFIG_FILE_DEFAULT  "type-trainer/config.txt"
-#define CONFIG_DATA_FILE_ACCURACY "type-trainer/accuracy"
-#define CONFIG_DATA_FILE_SPEED    "type-trainer/speed"
+#define CONFIG_DATA_FILE_SESSIONS "type-trainer/sessions"
+#define CONFIG_DATA_FILE_DICTIONARY_INDEX "type-trainer/dictionary.idx"
+#define CONFIG_DATA_FILE_BIGRAMS  "type-trainer/bigrams"
+#define CONFIG_DATA_FILE_PERCENTILES "type-trainer/percentiles"
+// History files of older versions, imported into the session file once.
+#define CONFIG_DATA_FILE_LEGACY_SPEED    "type-trainer/speed"
+#define CONFIG_DATA_FILE_LEGACY_ACCURACY "type-trainer/accuracy"
+
+// Every file the game reads or writes. Add an entry here and to the
+// table in config_file.c for a new file.
+typedef enum {
+    CONFIG_PATH_CONFIG,
+    CONFIG_PATH_SESSIONS,
+    CONFIG_PATH_DICTIONARY_INDEX,
+    CONFIG_PATH_BIGRAMS,
+    CONFIG_PATH_PERCENTILES,
+    CONFIG_PATH_LEGACY_SPEED,
+    CONFIG_PATH_LEGACY_ACCURACY,
+    CONFIG_PATH_COUNT
+} ConfigPath;
 
 bool createConfigFiles();
-bool ConfigFileInit(const char* file_name);
-bool ConfigFileExists(const char* file_name);
-bool ConfigFileEmpty(const char* file_name);
-bool ConfigFileWriteInt(const char* file_name, int number);
+bool ConfigFileInit(ConfigPath path);
+bool ConfigFileExists(ConfigPath path);
+bool ConfigFileEmpty(ConfigPath path);
+
+// Add tilde or XDG path to every file once, at startup.
+bool ConfigFileResolvePaths();
 
-// Add tilde or XDG path.
-const char* ConfigFileResolve(const char* file_name);
+// Resolved path of the file, NULL if it could not be resolved.
+const char* ConfigFilePath(ConfigPath path);
 
 #endif
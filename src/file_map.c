@@ -0,0 +1,96 @@
+#include "file_map.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// No mmap available, read the whole file into a single buffer instead.
+static bool readWholeFile(FileMap* map, const char* file_path) {
+    FILE* file = fopen(file_path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    rewind(file);
+    if (size < 0) {
+        fclose(file);
+        return false;
+    }
+
+    char* buffer = malloc(size > 0 ? (size_t)size : 1);
+    if (!buffer || fread(buffer, 1, (size_t)size, file) != (size_t)size) {
+        free(buffer);
+        fclose(file);
+        return false;
+    }
+    fclose(file);
+
+    map->data = buffer;
+    map->size = (size_t)size;
+    map->mapped = false;
+    return true;
+}
+#endif
+
+bool FileMap_open(FileMap* map, const char* file_path) {
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = false;
+
+#ifdef _WIN32
+    return readWholeFile(map, file_path);
+#else
+    int fd = open(file_path, O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return false;
+    }
+
+    // Empty files can't be mapped, treat them as an empty view.
+    if (st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+
+    map->data = data;
+    map->size = (size_t)st.st_size;
+    map->mapped = true;
+    return true;
+#endif
+}
+
+void FileMap_close(FileMap* map) {
+#ifndef _WIN32
+    if (map->mapped) {
+        munmap((void*)map->data, map->size);
+    }
+    else {
+        free((void*)map->data);
+    }
+#else
+    free((void*)map->data);
+#endif
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = false;
+}
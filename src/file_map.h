@@ -0,0 +1,20 @@
+#ifndef FILE_MAP_H
+#define FILE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Read-only view of a whole file.
+typedef struct {
+    const char* data;
+    size_t size;
+    bool mapped;
+} FileMap;
+
+// Map file into memory. Returns false if the file cannot be read.
+bool FileMap_open(FileMap* map, const char* file_path);
+
+// Release the view created by FileMap_open.
+void FileMap_close(FileMap* map);
+
+#endif
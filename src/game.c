@@ -1,116 +1,161 @@
 #include "game.h"
 #include "config.h"
 #include "config_file.h"
+#include "log.h"
+#include "sentence_view.h"
+#include "trace.h"
+#include "texture_registry.h"
 
+#include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 
 void initTextures(Game* game) {
-    if (!game->config.total_words.is_set) {
-        perror("Cannot continue");
+    TRACE_BEGIN("initTextures");
+    if (!Pipeline_swap(&game->pipeline, &game->round)) {
+        LOG_ERROR("Could not prepare a new round.\n");
+        game->close = true;
     }
-    game->sentence = strdup(Word_getSentence(&game->word, game->config.total_words.value.int_value));
-    game->textures = malloc(sizeof(Texture) * strlen(game->sentence));
-    game->colors = malloc(sizeof(int) * strlen(game->sentence));
+    TextLayout_invalidate(&game->layout);
+    TRACE_END("initTextures");
+}
 
-    if (!game->sentence || !game->textures || !game->colors) {
-        fprintf(stderr, "Memory allocation for texture data.\n");
-        return;
+bool Game_init(Game* game, int argc, char** argv) {
+    ConfigFileResolvePaths();
+    Config_init(&game->config);
+    if (Config_parseArguments(&game->config, argc, argv) != 0) {
+        return false;
     }
+    Trace_init(game->config.trace_file.value.str_value);
 
-    // Initialize a texture for each character in the sentence.
-    int i = 0;
-    for (const char *p = game->sentence; *p != '\0'; p++) {
-        char letter[2] = {*p, '\0'};
-        Texture_init(&game->textures[i], game->window.renderer, game->font, letter, game->config.color_text_default.value.color_value);
-        game->colors[i] = game->config.color_text_default.value.color_value;
-        i++;
+    game->font = TTF_OpenFont(game->config.font.value.str_value, game->config.font_size.value.int_value);
+    if (!game->font) {
+        SDL_Log("Failed to load the font! SDL_ttf Error: %s\n", SDL_GetError());
+        Trace_quit();
+        return false;
     }
-}
 
-void startGame(Game* game) {
-    clock_gettime(CLOCK_REALTIME, &game->startTime);
-}
+    // Without the watch no key would ever be scored.
+    if (!Input_init(&game->input, &game->core)) {
+        TTF_CloseFont(game->font);
+        Trace_quit();
+        return false;
+    }
 
-void endGame(Game* game) {
-    clock_gettime(CLOCK_REALTIME, &game->endTime);
-}
+    // Seed 0 means a different sequence every run. The picked seed is
+    // logged and never 0, so it can be passed back with --seed.
+    uint64_t seed = game->config.seed.value.uint64_value;
+    while (seed == 0) {
+        seed = Random_timeSeed();
+    }
+    Random_init(&game->random, seed);
+    game->roundNumber = 0;
+    LOG_INFO("Seed: %llu\n", (unsigned long long)seed);
 
-void Game_init(Game* game) {
-    Config_init(&game->config);
+    game->close = false;
     Window_init(&game->window);
-    Word_init(&game->word, game->config.dictionary.value.str_value);
-    game->font = TTF_OpenFont(game->config.font.value.str_value, game->config.font_size.value.int_value);
-    if (!game->font) {
-        SDL_Log("Failed to load the font! SDL_ttf Error: %s\n", SDL_GetError());
-        return;
+    Window_setVSync(&game->window, game->config.vsync.value.boolean_value);
+    TextureRegistry_setBudget((int64_t)game->config.texture_budget_mb.value.int_value * 1024 * 1024);
+
+    // Every glyph is drawn from the atlas, there's nothing to show without it.
+    if (!GlyphAtlas_init(&game->atlas, game->window.renderer, game->font)) {
+        SDL_Log("Failed to create the glyph atlas: %s\n", SDL_GetError());
+        TextureRegistry_quit();
+        Window_destroy(&game->window);
+        Input_destroy(&game->input);
+        TTF_CloseFont(game->font);
+        Trace_quit();
+        return false;
     }
+    Latency_init(&game->latency);
+
+    const char* bigrams_file = ConfigFilePath(CONFIG_PATH_BIGRAMS);
+    bool has_stats = TypingStats_init(&game->stats);
+    if (has_stats && bigrams_file) {
+        TypingStats_load(&game->stats, bigrams_file);
+    }
+    GameCore_init(&game->core, game->config.total_words.value.int_value,
+                  game->config.advance_on_failure.value.boolean_value, has_stats ? &game->stats : NULL);
     createConfigFiles();
-    GameMetrics_init(&game->metrics.metrics);
+    SessionStore_importLegacy(ConfigFilePath(CONFIG_PATH_SESSIONS), ConfigFilePath(CONFIG_PATH_LEGACY_SPEED),
+                              ConfigFilePath(CONFIG_PATH_LEGACY_ACCURACY));
+
+    // Round results are written by the persistence worker from here on.
+    const char* sessions_file = ConfigFilePath(CONFIG_PATH_SESSIONS);
+    const char* percentiles_file = ConfigFilePath(CONFIG_PATH_PERCENTILES);
+    if (!Persistence_init(&game->persistence, sessions_file, percentiles_file, bigrams_file)) {
+        LOG_ERROR("Could not start the persistence worker, rounds will be saved on the game thread.\n");
+    }
 
     // Load initial accuracy and speed.
-    const char* accuracy_file = ConfigFileResolve(CONFIG_DATA_FILE_ACCURACY);
-    const char* speed_file = ConfigFileResolve(CONFIG_DATA_FILE_SPEED);
-    GameMetrics_loadAccuracy(&game->metrics.metrics, accuracy_file);
-    GameMetrics_loadSpeed(&game->metrics.metrics, speed_file);
+    GameMetrics_init(&game->metrics.metrics);
+    GameMetrics_load(&game->metrics.metrics, sessions_file, percentiles_file);
+    LOG_INFO("%llu rounds played, average %.2f WPM (best %.2f, recent %.2f)\n",
+             (unsigned long long)game->metrics.metrics.speed.count, game->metrics.metrics.speed.mean,
+             game->metrics.metrics.speed.max, game->metrics.metrics.speed.ewma);
 
-    free((void*)accuracy_file);
-    free((void*)speed_file);
+    Word_init(&game->word, game->config.dictionary.value.str_value, ConfigFilePath(CONFIG_PATH_DICTIONARY_INDEX));
+    Word_setLengthRange(&game->word, game->config.min_word_length.value.int_value, game->config.max_word_length.value.int_value);
+
+    if (!game->config.total_words.is_set) {
+        perror("Cannot continue");
+    }
+    Round_init(&game->round);
+    // Without the worker no round can be built, the game closes before the
+    // first frame and Game_destroy still cleans up.
+    if (!Pipeline_init(&game->pipeline, &game->word, &game->random, game->config.total_words.value.int_value,
+                       game->config.color_text_default.value.color_value)) {
+        LOG_ERROR("Could not start the round pipeline.\n");
+        game->close = true;
+    }
+    TextBatch_init(&game->batch);
+    TextLayout_init(&game->layout);
+    PerfHud_init(&game->hud);
 
     char accuracy[50];
     char speed[50];
-    snprintf(accuracy, sizeof(accuracy), "Last accuracy: %.2f", GameMetrics_getAverageAccuracy(&game->metrics.metrics));
-    snprintf(speed, sizeof(speed), "Last speed: %.2f", GameMetrics_getAverageSpeed(&game->metrics.metrics));
+    snprintf(accuracy, sizeof(accuracy), "Last accuracy: %.2f", GameMetrics_getLastAccuracy(&game->metrics.metrics));
+    snprintf(speed, sizeof(speed), "Last speed: %.2f", GameMetrics_getLastSpeed(&game->metrics.metrics));
     Texture_init(&game->metrics.textures.accuracyTexture, game->window.renderer, game->font, accuracy, game->config.color_text_default.value.color_value);
     Texture_init(&game->metrics.textures.speedTexture, game->window.renderer, game->font, speed, game->config.color_text_default.value.color_value);
-}
-
-void destroyTextures(Game* game) {
-    for (size_t i = 0; i < strlen(game->sentence); i++) {
-        Texture_destroy(&game->textures[i]);
-    }
-    free(game->colors);
-    free(game->sentence);
+    Texture_init(&game->metrics.textures.percentileTexture, game->window.renderer, game->font, " ", game->config.color_text_default.value.color_value);
+    return true;
 }
 
 void Game_destroy(Game* game) {
+    Input_destroy(&game->input);
+
+    // Flush the queued rounds before the data they were copied from goes away.
+    Persistence_destroy(&game->persistence);
+    Latency_print(&game->latency);
+    TypingStats_printSlowest(&game->stats, 5);
+    TypingStats_destroy(&game->stats);
+
+    // The pipeline worker uses the dictionary, stop it first.
+    Pipeline_destroy(&game->pipeline);
     Word_destroy(&game->word);
 
-    destroyTextures(game);
+    Round_destroy(&game->round);
+    TextBatch_destroy(&game->batch);
+    TextLayout_destroy(&game->layout);
+    PerfHud_destroy(&game->hud);
+    GlyphAtlas_destroy(&game->atlas);
 
+    GameMetrics_free(&game->metrics.metrics);
     Texture_destroy(&game->metrics.textures.accuracyTexture);
     Texture_destroy(&game->metrics.textures.speedTexture);
+    Texture_destroy(&game->metrics.textures.percentileTexture);
 
+    // Everything created from the renderer should be gone by now.
+    TextureRegistry_quit();
     Window_destroy(&game->window);
     TTF_CloseFont(game->font);
+    Trace_quit();
 }
 
 void renderText(Game* game) {
-    size_t sentenceLen = strlen(game->sentence);
-    int xpadding = 100;
-    int ypadding = xpadding * 4;
-    int maxLineWidth = game->window.width - xpadding * 2;
-
-    int currentX = xpadding;
-    int currentY = ypadding;
-    int lineIndex = 0;
-
-    for (size_t i = 0; i < sentenceLen; i++) {
-        int w = game->textures[i].width;
-
-        // If adding this character would exceed the max width, move to the next line
-        if (currentX + w > xpadding + maxLineWidth) {
-            currentX = xpadding;
-            lineIndex++;
-            currentY = ypadding + lineIndex * xpadding;
-        }
-
-        // Render the texture at the current position
-        Texture_render(&game->textures[i], game->window.renderer, currentX, currentY, game->colors[i]);
-
-        // Advance to the next character's position
-        currentX += w;
-    }
+    SentenceView_render(&game->layout, game->round.positions, &game->batch, &game->atlas, game->window.renderer,
+                        game->round.sentence.data, game->round.glyphs, game->round.colors,
+                        game->round.sentence.length, game->window.width);
 }
 
 void renderMetrics(Game* game) {
@@ -122,6 +167,7 @@ void renderMetrics(Game* game) {
 
     Texture_render(&game->metrics.textures.speedTexture, game->window.renderer, offset_x, offset_y, text_color);
     Texture_render(&game->metrics.textures.accuracyTexture, game->window.renderer, w - offset_x - game->metrics.textures.speedTexture.width, offset_y, text_color);
+    Texture_render(&game->metrics.textures.percentileTexture, game->window.renderer, offset_x, h - offset_y - game->metrics.textures.percentileTexture.height, text_color);
 }
 
 void render(Game* game) {
@@ -129,144 +175,184 @@ void render(Game* game) {
     Window_clear(&game->window);
 
     if (!game->window.tooSmall) {
+        TRACE_BEGIN("renderText");
         renderText(game);
+        TRACE_END("renderText");
+        TRACE_BEGIN("renderMetrics");
         renderMetrics(game);
+        TRACE_END("renderMetrics");
+        PerfHud_render(&game->hud, game->window.renderer, &game->atlas, &game->latency, 10, 10);
     }
+    TRACE_BEGIN("Window_render");
     Window_render(&game->window);
-}
-
-double gameDuration(Game* game) {
-    return (double)(game->endTime.tv_sec - game->startTime.tv_sec) +
-        (double)(game->endTime.tv_nsec - game->startTime.tv_nsec) / 1e9;
-}
-
-double gameWpm(Game* game, double duration) {
-    return game->config.total_words.value.int_value / (duration / 60.0);
-}
-
-double gameAccuracy(Game* game) {
-    return game->metrics.accuracy.failures > 0 ? (1 - (double)game->metrics.accuracy.failures / (double)game->metrics.accuracy.lastLetter) * 100 : 100;
+    TRACE_END("Window_render");
+    Latency_framePresented(&game->latency, SDL_GetTicksNS());
 }
 
 void restart(Game* game) {
-    endGame(game);
-    fflush(stdout);
-    printf("Game over!\n");
-    double game_duration = gameDuration(game);
-    double game_wpm = gameWpm(game, game_duration);
-    double game_accuracy = gameAccuracy(game);
-
-    ConfigFileWriteInt(CONFIG_DATA_FILE_ACCURACY, game_accuracy);
-    ConfigFileWriteInt(CONFIG_DATA_FILE_SPEED, game_wpm);
+    TRACE_BEGIN("restart");
+    LOG_INFO("Game over!\n");
+    double game_duration = GameCore_duration(&game->core);
+    double game_wpm = GameCore_wpm(&game->core);
+    double game_accuracy = GameCore_accuracy(&game->core);
+
+    SessionRecord record = {
+        .timestamp = (int64_t)time(NULL),
+        .wpm = game_wpm,
+        .accuracy = game_accuracy,
+        .duration = game_duration,
+        .seed = game->random.seed,
+        .round = game->roundNumber++,
+        .word_count = (uint32_t)game->config.total_words.value.int_value,
+    };
+    GameMetrics_addRound(&game->metrics.metrics, &record);
+    Persistence_submitRound(&game->persistence, &record, &game->metrics.metrics, game->stats.bigrams);
 
     Game_setup(game);
+    TRACE_END("restart");
 }
 
-void updateWrittenKey(Game* game, char expected_char, bool isCorrect) {
-    char* underscore = {"_"};
+void updateWrittenKey(Game* game, size_t index, bool isCorrect) {
     SDL_Color color = isCorrect ? game->config.color_text_typed.value.color_value :
                                   game->config.color_text_error.value.color_value;
     // Convert spaces to underscore.
-    if (expected_char == 32) {
-        Texture_update(&game->textures[game->checkIndex], game->window.renderer, game->font, underscore, color);
-    }
-    if (isCorrect) {
-        game->colors[game->checkIndex] = color;
-        game->checkIndex++;
-    }
-    else {
-        game->colors[game->checkIndex] = color;
-        if (game->config.advance_on_failure.value.boolean_value) {
-            game->checkIndex++;
-        }
-        game->metrics.accuracy.failures++;
-    }
-    if (game->shiftPressed) {
-        game->shiftPressed = false;
-    }
-    if (game->checkIndex >= game->metrics.accuracy.lastLetter) {
-        restart(game);
+    if (game->round.sentence.data[index] == 32) {
+        game->round.glyphs[index] = '_';
     }
+    game->round.colors[index] = color;
 }
 
 void updateMetricsTextures(Game* game) {
+    TRACE_BEGIN("updateMetricsTextures");
     char accuracy[50];
     char speed[50];
 
-    const char* accuracy_file = ConfigFileResolve(CONFIG_DATA_FILE_ACCURACY);
-    const char* speed_file = ConfigFileResolve(CONFIG_DATA_FILE_SPEED);
+    snprintf(accuracy, sizeof(accuracy), "Last accuracy: %.2f", GameMetrics_getLastAccuracy(&game->metrics.metrics));
+    snprintf(speed, sizeof(speed), "Last speed: %.2f", GameMetrics_getLastSpeed(&game->metrics.metrics));
+    Texture_update(&game->metrics.textures.accuracyTexture, game->window.renderer, game->font, accuracy, game->config.color_text_default.value.color_value);
+    Texture_update(&game->metrics.textures.speedTexture, game->window.renderer, game->font, speed, game->config.color_text_default.value.color_value);
+
+    const GameMetrics* metrics = &game->metrics.metrics;
+    if (metrics->speed_sketch.total > 0) {
+        char percentiles[80];
+        snprintf(percentiles, sizeof(percentiles), "p50 / p90 WPM: %.1f / %.1f  (best %.1f)",
+                 GameMetrics_getSpeedPercentile(metrics, 50.0),
+                 GameMetrics_getSpeedPercentile(metrics, 90.0),
+                 GameMetrics_getSpeedPercentile(metrics, 100.0));
+        Texture_update(&game->metrics.textures.percentileTexture, game->window.renderer, game->font, percentiles, game->config.color_text_default.value.color_value);
+    }
+    TRACE_END("updateMetricsTextures");
+}
+
+void handleEvent(Game* game, SDL_Event e) {
+    Window_resize(&game->window, e);
+    if (e.type == SDL_EVENT_WINDOW_RESIZED) {
+        TextLayout_invalidate(&game->layout);
+    }
+    if (e.type >= SDL_EVENT_WINDOW_FIRST && e.type <= SDL_EVENT_WINDOW_LAST) {
+        game->dirty = true;
+    }
 
-    GameMetrics_loadAccuracy(&game->metrics.metrics, accuracy_file);
-    GameMetrics_loadSpeed(&game->metrics.metrics, speed_file);
+    // The main loop shuts down once the game is closed.
+    if (e.type == SDL_EVENT_QUIT || (e.type == SDL_EVENT_KEY_DOWN && (e.key.key == SDLK_ESCAPE))) {
+        game->close = true;
+        return;
+    }
 
-    free((void*)accuracy_file);
-    free((void*)speed_file);
+    else if (e.type == SDL_EVENT_KEY_DOWN) {
+        game->dirty = true;
 
-    snprintf(accuracy, sizeof(accuracy), "Last accuracy: %.2f", GameMetrics_getAverageAccuracy(&game->metrics.metrics));
-    snprintf(speed, sizeof(speed), "Last speed: %.2f", GameMetrics_getAverageSpeed(&game->metrics.metrics));
-    Texture_update(&game->metrics.textures.accuracyTexture, game->window.renderer, game->font, accuracy, game->config.color_text_default.value.color_value);
-    Texture_update(&game->metrics.textures.speedTexture, game->window.renderer, game->font, speed, game->config.color_text_default.value.color_value);
+        int key = e.key.key;
+        if (key == SDLK_F12) {
+            Latency_print(&game->latency);
+            TypingStats_printSlowest(&game->stats, 5);
+            return;
+        }
+        if (key == SDLK_F3) {
+            game->hud.visible = !game->hud.visible;
+            return;
+        }
+        if (key == SDLK_LGUI) {
+            LOG_DEBUG("Left Super key (LGUI) pressed\n");
+            return;
+        }
+        if (key == SDLK_RGUI) {
+            LOG_DEBUG("Right Super key (RGUI) pressed\n");
+            return;
+        }
+        // Typed keys were already scored by the input watch.
+    }
+}
+
+// Paint the keys scored since the last frame.
+void handleScoredKeys(Game* game) {
+    InputKey scored;
+    while (Input_poll(&game->input, &scored)) {
+        game->dirty = true;
+        Latency_keyPressed(&game->latency, scored.timestamp_ns);
+
+        bool correct = scored.result == GAME_CORE_KEY_CORRECT;
+        LOG_DEBUG("%s Expected char: %c\n", correct ? "Correct!" : "Incorrect!", game->round.sentence.data[scored.index]);
+        updateWrittenKey(game, scored.index, correct);
+
+        // Keys typed after the finishing key wait in the watch and are
+        // scored against the next round when it starts.
+        if (scored.finished) {
+            restart(game);
+        }
+    }
 }
 
 void eventHandler(Game* game) {
     SDL_Event e;
-    while (SDL_PollEvent(&e)) {
-        Window_resize(&game->window, e);
 
-        if (e.type == SDL_EVENT_QUIT || (e.type == SDL_EVENT_KEY_DOWN && (e.key.key == SDLK_ESCAPE))) {
-            game->close = true;
-            Game_destroy(game);
-            exit(0);
-            return;
+    // Sleep until something happens, unless frames are paced by vsync that
+    // actually took effect, otherwise the loop would spin. The HUD graphs keep
+    // moving at about 60 frames per second.
+    bool waited = false;
+    if (!game->dirty && !game->window.vsync) {
+        if (game->hud.visible) {
+            waited = SDL_WaitEventTimeout(&e, 16);
+            game->dirty = true;
+        } else {
+            waited = SDL_WaitEvent(&e);
         }
+    }
 
-        else if (e.type == SDL_EVENT_KEY_DOWN) {
-            fflush(stdout);
-
-            int key = e.key.key;
-            if (key == SDLK_LSHIFT || key == SDLK_RSHIFT) {
-                game->shiftPressed = true;
-                continue;
-            }
-            if (key == SDLK_LGUI) {
-                printf("Left Super key (LGUI) pressed\n");
-                continue;
-            }
-            if (key == SDLK_RGUI) {
-                printf("Right Super key (RGUI) pressed\n");
-                continue;
-            }
-
-            char expected_char = game->sentence[game->checkIndex];
-            bool correct = (game->shiftPressed && toupper(key) == expected_char) ||
-                           (!game->shiftPressed && key == expected_char);
-
-            if (correct) {
-                printf("Correct! Input: %c, expected char: %c\n", key, expected_char);
-                updateWrittenKey(game, expected_char, correct);
-            }
-            else {
-                printf("Incorrect! Input char: %c, expected char: %c \n", key, expected_char);
-                updateWrittenKey(game, expected_char, correct);
-            }
-        }
+    // The zone starts after the wait so it only covers handling.
+    TRACE_BEGIN("eventHandler");
+    if (waited) {
+        handleEvent(game, e);
+    }
+    while (!game->close && SDL_PollEvent(&e)) {
+        handleEvent(game, e);
+    }
+    if (!game->close) {
+        handleScoredKeys(game);
     }
+    TRACE_END("eventHandler");
 }
 
 void Game_update(Game* game) {
     eventHandler(game);
-    render(game);
+
+    if (game->close) {
+        return;
+    }
+    if (game->dirty || game->window.vsync) {
+        render(game);
+        game->dirty = false;
+    }
 }
 
 void Game_setup(Game* game) {
+    game->dirty = true;
     initTextures(game);
+    if (game->close) {
+        return;
+    }
 
     updateMetricsTextures(game);
-    game->checkIndex = 0;
-    game->metrics.accuracy.failures = 0;
-    game->metrics.accuracy.lastLetter = strlen(game->sentence);
-    game->close = false;
-    game->shiftPressed = false;
-    startGame(game);
+    Input_startRound(&game->input, game->round.sentence.data, game->round.sentence.length, SDL_GetTicksNS());
 }
 
@@ -5,7 +5,19 @@
 #include "texture.h"
 #include "window.h"
 #include "word.h"
+#include "random.h"
+#include "sentence.h"
+#include "pipeline.h"
+#include "glyph_atlas.h"
+#include "text_batch.h"
+#include "text_layout.h"
+#include "latency.h"
+#include "typing_stats.h"
 #include "game_metrics.h"
+#include "persistence.h"
+#include "game_core.h"
+#include "input.h"
+#include "perf_hud.h"
 
 #include <time.h>
 #include <stdint.h>
@@ -15,17 +27,12 @@
 typedef struct {
     Texture accuracyTexture;
     Texture speedTexture;
+    Texture percentileTexture;
 } MetricsTextures;
 
-typedef struct {
-    uint32_t failures;
-    uint32_t lastLetter;
-} Accuracy;
-
 typedef struct {
     MetricsTextures textures;
     GameMetrics metrics;
-    Accuracy accuracy;
 } Metrics;
 
 typedef struct {
@@ -38,33 +45,57 @@ typedef struct {
     // Dictionary file used for words.
     Word word;
 
+    // Random generator used for picking words.
+    Random random;
+
     // Program font.
     TTF_Font* font;
 
+    // Glyphs of the font for drawing the sentence.
+    GlyphAtlas atlas;
+    TextBatch batch;
+    TextLayout layout;
+
     // Metrics data
     Metrics metrics;
 
+    // Key press to present latency.
+    Latency latency;
+
+    // Key presses of the round and the bigram history.
+    TypingStats stats;
+
     // The writable text.
-    char* sentence;
-    Texture* textures;
-    SDL_Color* colors;
+    Round round;
+
+    // Prepares the next round in the background.
+    Pipeline pipeline;
+
+    // Writes round results off the game thread.
+    Persistence persistence;
+
+    // Rounds played in this session.
+    uint32_t roundNumber;
+
+    // Typing state of the current round.
+    GameCore core;
 
-    // Index the game is currently writing next.
-    uint32_t checkIndex;
+    // Scores key presses as SDL receives them.
+    Input input;
 
-    // Time measurement.
-    struct timespec startTime;
-    struct timespec endTime;
+    // Performance overlay, toggled with F3.
+    PerfHud hud;
 
-    // Is the shift-key pressed for capital letters.
-    bool shiftPressed;
+    // Something changed since the last frame was presented.
+    bool dirty;
 
     // The application should close.
     bool close;
 } Game;
 
-// Allocate for game.
-void Game_init(Game* game);
+// Allocate for game. Command line arguments override the config file.
+// Returns false if the game can't start, with nothing left to destroy.
+bool Game_init(Game* game, int argc, char** argv);
 
 // Setup for new game.
 void Game_setup(Game* game);
@@ -72,7 +103,8 @@ void Game_setup(Game* game);
 // Deallocate game.
 void Game_destroy(Game* game);
 
-// Update game loop.
+// Update game loop. Sleeps until the next event unless vsync is enabled, and
+// presents a frame only when something changed.
 void Game_update(Game* game);
 
 #endif // GAME_H
@@ -0,0 +1,76 @@
+#include "game_core.h"
+
+#include <ctype.h>
+
+void GameCore_init(GameCore* core, int total_words, bool advance_on_failure, TypingStats* stats) {
+    core->text = NULL;
+    core->length = 0;
+    core->checkIndex = 0;
+    core->failures = 0;
+    core->shiftPressed = false;
+    core->advanceOnFailure = advance_on_failure;
+    core->totalWords = total_words;
+    core->startNs = 0;
+    core->endNs = 0;
+    core->stats = stats;
+}
+
+void GameCore_startRound(GameCore* core, const char* text, size_t length, uint64_t timestamp_ns) {
+    core->text = text;
+    core->length = length;
+    core->checkIndex = 0;
+    core->failures = 0;
+    core->shiftPressed = false;
+    core->startNs = timestamp_ns;
+    core->endNs = timestamp_ns;
+    if (core->stats) {
+        TypingStats_startRound(core->stats, length);
+    }
+}
+
+GameCoreKeyResult GameCore_feedKey(GameCore* core, uint64_t timestamp_ns, int keycode) {
+    if (keycode == GAME_CORE_KEY_SHIFT) {
+        core->shiftPressed = true;
+        return GAME_CORE_KEY_IGNORED;
+    }
+    if (GameCore_finished(core)) {
+        return GAME_CORE_KEY_IGNORED;
+    }
+
+    char expected = core->text[core->checkIndex];
+    int typed = core->shiftPressed && keycode < 128 ? toupper(keycode) : keycode;
+    bool correct = typed == expected;
+
+    if (core->stats) {
+        TypingStats_recordKey(core->stats, timestamp_ns, expected, typed < 128 ? (char)typed : 0, correct);
+    }
+
+    if (correct || core->advanceOnFailure) {
+        core->checkIndex++;
+    }
+    if (!correct) {
+        core->failures++;
+    }
+    core->shiftPressed = false;
+
+    if (GameCore_finished(core)) {
+        core->endNs = timestamp_ns;
+    }
+    return correct ? GAME_CORE_KEY_CORRECT : GAME_CORE_KEY_INCORRECT;
+}
+
+bool GameCore_finished(const GameCore* core) {
+    return core->checkIndex >= core->length;
+}
+
+double GameCore_duration(const GameCore* core) {
+    return (double)(core->endNs - core->startNs) / 1e9;
+}
+
+double GameCore_wpm(const GameCore* core) {
+    return core->totalWords / (GameCore_duration(core) / 60.0);
+}
+
+double GameCore_accuracy(const GameCore* core) {
+    return core->failures > 0 ? (1 - (double)core->failures / (double)core->length) * 100 : 100;
+}
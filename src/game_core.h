@@ -0,0 +1,64 @@
+#ifndef GAME_CORE_H
+#define GAME_CORE_H
+
+#include "typing_stats.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Keycodes are ASCII characters, except for this one marking a shift press.
+#define GAME_CORE_KEY_SHIFT 0x10000
+
+typedef enum {
+    GAME_CORE_KEY_IGNORED,
+    GAME_CORE_KEY_CORRECT,
+    GAME_CORE_KEY_INCORRECT
+} GameCoreKeyResult;
+
+// State of a single round, free of any window, font or event types so it can
+// be driven headless.
+typedef struct {
+    // Sentence of the round, owned by the caller.
+    const char* text;
+    size_t length;
+
+    // Index the player is currently writing next.
+    size_t checkIndex;
+    uint32_t failures;
+    bool shiftPressed;
+
+    bool advanceOnFailure;
+    int totalWords;
+
+    // Monotonic nanoseconds of the round start and the finishing key.
+    uint64_t startNs;
+    uint64_t endNs;
+
+    // Optional, receives every key press.
+    TypingStats* stats;
+} GameCore;
+
+// Initialize the core. stats may be NULL.
+void GameCore_init(GameCore* core, int total_words, bool advance_on_failure, TypingStats* stats);
+
+// Start a round on text at timestamp_ns.
+void GameCore_startRound(GameCore* core, const char* text, size_t length, uint64_t timestamp_ns);
+
+// Apply a key press. The key at the previous checkIndex was judged unless the
+// result is GAME_CORE_KEY_IGNORED.
+GameCoreKeyResult GameCore_feedKey(GameCore* core, uint64_t timestamp_ns, int keycode);
+
+// Whether the whole sentence has been typed.
+bool GameCore_finished(const GameCore* core);
+
+// Round duration in seconds.
+double GameCore_duration(const GameCore* core);
+
+// Speed of the round in WPM.
+double GameCore_wpm(const GameCore* core);
+
+// Accuracy of the round as a percentage.
+double GameCore_accuracy(const GameCore* core);
+
+#endif
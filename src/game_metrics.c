@@ -1,87 +1,165 @@
 #include "game_metrics.h"
 
+#include "atomic_file.h"
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define SKETCH_FILE_MAGIC   "TTSKETCH"
+#define SKETCH_FILE_VERSION 1
+
+void RunningStat_init(RunningStat* stat) {
+    stat->count = 0;
+    stat->mean = 0.0;
+    stat->m2 = 0.0;
+    stat->min = 0.0;
+    stat->max = 0.0;
+    stat->ewma = 0.0;
+}
+
+void RunningStat_add(RunningStat* stat, double value) {
+    stat->count++;
+    if (stat->count == 1) {
+        stat->min = value;
+        stat->max = value;
+        stat->ewma = value;
+    } else {
+        if (value < stat->min) stat->min = value;
+        if (value > stat->max) stat->max = value;
+        stat->ewma += GAME_METRICS_EWMA_ALPHA * (value - stat->ewma);
+    }
+
+    double delta = value - stat->mean;
+    stat->mean += delta / stat->count;
+    stat->m2 += delta * (value - stat->mean);
+}
+
+double RunningStat_variance(const RunningStat* stat) {
+    return stat->count > 1 ? stat->m2 / (stat->count - 1) : 0.0;
+}
 
 // Initialize the GameMetrics structure with default values
 void GameMetrics_init(GameMetrics* metrics) {
-    metrics->accuracy_data = NULL;
-    metrics->accuracy_count = 0;
-    metrics->speed_data = NULL;
-    metrics->speed_count = 0;
+    RunningStat_init(&metrics->speed);
+    RunningStat_init(&metrics->accuracy);
+    Histogram_init(&metrics->speed_sketch);
+    Histogram_init(&metrics->accuracy_sketch);
+    memset(&metrics->last, 0, sizeof(metrics->last));
 }
 
-// Load data from a file into a dynamically allocated array.
-static int GameMetrics_loadData(const char* file_path, double** data, size_t* count) {
-    FILE* file = fopen(file_path, "r");
-    if (!file) {
-        perror("Failed to open file");
-        return -1;
-    }
+static uint64_t sketchValue(double value) {
+    return value > 0.0 ? (uint64_t)(value * GAME_METRICS_SKETCH_SCALE + 0.5) : 0;
+}
 
-    double value;
-    size_t temp_count = 0;
-    double* temp_data = NULL;
-
-    while (fscanf(file, "%lf", &value) == 1) {
-        double* new_data = realloc(temp_data, sizeof(double) * (temp_count + 1));
-        if (!new_data) {
-            perror("Memory allocation failed");
-            free(temp_data);
-            fclose(file);
-            return -1;
-        }
-        temp_data = new_data;
-        temp_data[temp_count++] = value;
+static void recordSketch(GameMetrics* metrics, const SessionRecord* record) {
+    Histogram_record(&metrics->speed_sketch, sketchValue(record->wpm));
+    Histogram_record(&metrics->accuracy_sketch, sketchValue(record->accuracy));
+}
+
+static bool loadSketch(GameMetrics* metrics, const char* sketch_path) {
+    FILE* file = fopen(sketch_path, "rb");
+    if (!file) {
+        return false;
     }
 
+    char magic[8];
+    uint32_t version;
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1 &&
+              fread(&version, sizeof(version), 1, file) == 1 &&
+              memcmp(magic, SKETCH_FILE_MAGIC, sizeof(magic)) == 0 &&
+              version == SKETCH_FILE_VERSION &&
+              fread(&metrics->speed_sketch, sizeof(Histogram), 1, file) == 1 &&
+              fread(&metrics->accuracy_sketch, sizeof(Histogram), 1, file) == 1;
     fclose(file);
-    *data = temp_data;
-    *count = temp_count;
-    return 0;
-}
 
-// Load accuracy data
-int GameMetrics_loadAccuracy(GameMetrics* metrics, const char* file_path) {
-    return GameMetrics_loadData(file_path, &metrics->accuracy_data, &metrics->accuracy_count);
+    if (!ok) {
+        Histogram_init(&metrics->speed_sketch);
+        Histogram_init(&metrics->accuracy_sketch);
+    }
+    return ok;
 }
 
-// Load speed data
-int GameMetrics_loadSpeed(GameMetrics* metrics, const char* file_path) {
-    return GameMetrics_loadData(file_path, &metrics->speed_data, &metrics->speed_count);
+bool GameMetrics_saveSketch(const GameMetrics* metrics, const char* sketch_path) {
+    AtomicFile atomic;
+    if (!AtomicFile_open(&atomic, sketch_path)) {
+        return false;
+    }
+
+    uint32_t version = SKETCH_FILE_VERSION;
+    bool ok = fwrite(SKETCH_FILE_MAGIC, 8, 1, atomic.file) == 1 &&
+              fwrite(&version, sizeof(version), 1, atomic.file) == 1 &&
+              fwrite(&metrics->speed_sketch, sizeof(Histogram), 1, atomic.file) == 1 &&
+              fwrite(&metrics->accuracy_sketch, sizeof(Histogram), 1, atomic.file) == 1;
+    return AtomicFile_commit(&atomic, ok);
 }
 
-// Calculate the average of an array
-static double GameMetrics_getAverage(const double* data, size_t count) {
-    if (count == 0) {
-        return 0.0;
+// Read the session file once; later rounds are added with GameMetrics_addRound.
+int GameMetrics_load(GameMetrics* metrics, const char* file_path, const char* sketch_path) {
+    SessionStore sessions;
+    if (!file_path || !SessionStore_open(&sessions, file_path)) {
+        perror("Failed to open file");
+        return -1;
+    }
+
+    // A stored sketch may cover rounds the session file has lost, keep it
+    // unless the session file is ahead of it.
+    bool sketch_current = sketch_path && loadSketch(metrics, sketch_path) &&
+                          metrics->speed_sketch.total >= sessions.count;
+    if (!sketch_current) {
+        Histogram_init(&metrics->speed_sketch);
+        Histogram_init(&metrics->accuracy_sketch);
     }
 
-    double total = 0.0;
-    for (size_t i = 0; i < count; i++) {
-        total += data[i];
+    for (size_t i = 0; i < sessions.count; i++) {
+        const SessionRecord* record = &sessions.records[i];
+        RunningStat_add(&metrics->speed, record->wpm);
+        RunningStat_add(&metrics->accuracy, record->accuracy);
+        if (!sketch_current) {
+            recordSketch(metrics, record);
+        }
+        metrics->last = *record;
     }
+    SessionStore_close(&sessions);
+    return 0;
+}
 
-    return total / count;
+void GameMetrics_addRound(GameMetrics* metrics, const SessionRecord* record) {
+    RunningStat_add(&metrics->speed, record->wpm);
+    RunningStat_add(&metrics->accuracy, record->accuracy);
+    recordSketch(metrics, record);
+    metrics->last = *record;
 }
 
 // Get average speed
 double GameMetrics_getAverageSpeed(const GameMetrics* metrics) {
-    return GameMetrics_getAverage(metrics->speed_data, metrics->speed_count);
+    return metrics->speed.mean;
 }
 
 // Get average accuracy
 double GameMetrics_getAverageAccuracy(const GameMetrics* metrics) {
-    return GameMetrics_getAverage(metrics->accuracy_data, metrics->accuracy_count);
+    return metrics->accuracy.mean;
 }
 
-// Free allocated memory used in GameMetrics
-void GameMetrics_free(GameMetrics* metrics) {
-    free(metrics->accuracy_data);
-    free(metrics->speed_data);
-    metrics->accuracy_data = NULL;
-    metrics->speed_data = NULL;
-    metrics->accuracy_count = 0;
-    metrics->speed_count = 0;
+double GameMetrics_getSpeedPercentile(const GameMetrics* metrics, double percentile) {
+    return Histogram_percentile(&metrics->speed_sketch, percentile) / GAME_METRICS_SKETCH_SCALE;
+}
+
+double GameMetrics_getAccuracyPercentile(const GameMetrics* metrics, double percentile) {
+    return Histogram_percentile(&metrics->accuracy_sketch, percentile) / GAME_METRICS_SKETCH_SCALE;
+}
+
+// Get speed of the latest round
+double GameMetrics_getLastSpeed(const GameMetrics* metrics) {
+    return metrics->last.wpm;
+}
+
+// Get accuracy of the latest round
+double GameMetrics_getLastAccuracy(const GameMetrics* metrics) {
+    return metrics->last.accuracy;
 }
 
+// Nothing is held open after loading
+void GameMetrics_free(GameMetrics* metrics) {
+    (void)metrics;
+}
@@ -1,26 +1,63 @@
 #ifndef GAME_METRICS_H
 #define GAME_METRICS_H
 
+#include "session_store.h"
+#include "histogram.h"
+
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+// Sketches count hundredths of a WPM or accuracy percent.
+#define GAME_METRICS_SKETCH_SCALE 100.0
+
+// Weight of the latest round in the recent average.
+#define GAME_METRICS_EWMA_ALPHA 0.2
 
+// Running aggregates over a stream of samples, updated in O(1).
 typedef struct {
-    // Correctly read letters.
-    double* accuracy_data;
-    size_t accuracy_count;
+    uint64_t count;
+    double mean;
+    // Sum of squared differences from the mean (Welford).
+    double m2;
+    double min;
+    double max;
+    // Exponentially weighted recent average.
+    double ewma;
+} RunningStat;
 
-    // Correctly read words.
-    double* speed_data;
-    size_t speed_count;
+typedef struct {
+    RunningStat speed;
+    RunningStat accuracy;
+    // Quantile sketches over the whole history, persisted on their own so
+    // they outlive the session file.
+    Histogram speed_sketch;
+    Histogram accuracy_sketch;
+    // Latest round, zeroed when there is none.
+    SessionRecord last;
 } GameMetrics;
 
+// Reset a RunningStat to no samples
+void RunningStat_init(RunningStat* stat);
+
+// Fold a sample into the aggregates
+void RunningStat_add(RunningStat* stat, double value);
+
+// Sample variance, 0 with fewer than two samples
+double RunningStat_variance(const RunningStat* stat);
+
 // Initialize a GameMetrics structure
 void GameMetrics_init(GameMetrics* metrics);
 
-// Load accuracy data from a file
-int GameMetrics_loadAccuracy(GameMetrics* metrics, const char* file_path);
+// Fold every stored round from the session file into the aggregates. The
+// sketches come from sketch_path unless the session file holds more rounds.
+int GameMetrics_load(GameMetrics* metrics, const char* file_path, const char* sketch_path);
+
+// Write the sketches to sketch_path
+bool GameMetrics_saveSketch(const GameMetrics* metrics, const char* sketch_path);
 
-// Load speed data from a file
-int GameMetrics_loadSpeed(GameMetrics* metrics, const char* file_path);
+// Fold a finished round into the aggregates
+void GameMetrics_addRound(GameMetrics* metrics, const SessionRecord* record);
 
 // Calculate the average speed in WPM
 double GameMetrics_getAverageSpeed(const GameMetrics* metrics);
@@ -28,6 +65,18 @@ double GameMetrics_getAverageSpeed(const GameMetrics* metrics);
 // Calculate the average accuracy as a percentage
 double GameMetrics_getAverageAccuracy(const GameMetrics* metrics);
 
+// Speed at the percentile (0-100) of every round in WPM
+double GameMetrics_getSpeedPercentile(const GameMetrics* metrics, double percentile);
+
+// Accuracy at the percentile (0-100) of every round as a percentage
+double GameMetrics_getAccuracyPercentile(const GameMetrics* metrics, double percentile);
+
+// Speed of the latest round in WPM
+double GameMetrics_getLastSpeed(const GameMetrics* metrics);
+
+// Accuracy of the latest round as a percentage
+double GameMetrics_getLastAccuracy(const GameMetrics* metrics);
+
 // Free resources used by GameMetrics
 void GameMetrics_free(GameMetrics* metrics);
 
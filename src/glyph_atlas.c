@@ -0,0 +1,68 @@
+#include "glyph_atlas.h"
+
+// Glyphs per atlas row.
+#define GLYPH_ATLAS_COLUMNS 16
+
+bool GlyphAtlas_init(GlyphAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font) {
+    SDL_Color white = {255, 255, 255, 255};
+    SDL_Surface* surfaces[GLYPH_ATLAS_COUNT];
+    int cell_width = 0;
+    int cell_height = 0;
+
+    atlas->texture.texture = NULL;
+    atlas->height = 0;
+
+    // Rasterize every glyph to find the cell size.
+    for (int i = 0; i < GLYPH_ATLAS_COUNT; i++) {
+        char letter[2] = {(char)(GLYPH_ATLAS_FIRST + i), '\0'};
+        surfaces[i] = TTF_RenderText_Solid(font, letter, 1, white);
+        if (surfaces[i]) {
+            cell_width = surfaces[i]->w > cell_width ? surfaces[i]->w : cell_width;
+            cell_height = surfaces[i]->h > cell_height ? surfaces[i]->h : cell_height;
+        }
+    }
+
+    int rows = (GLYPH_ATLAS_COUNT + GLYPH_ATLAS_COLUMNS - 1) / GLYPH_ATLAS_COLUMNS;
+    SDL_Surface* sheet = NULL;
+    if (cell_width > 0 && cell_height > 0) {
+        sheet = SDL_CreateSurface(cell_width * GLYPH_ATLAS_COLUMNS, cell_height * rows, SDL_PIXELFORMAT_RGBA32);
+    }
+
+    for (int i = 0; i < GLYPH_ATLAS_COUNT; i++) {
+        SDL_Rect cell = {
+            (i % GLYPH_ATLAS_COLUMNS) * cell_width,
+            (i / GLYPH_ATLAS_COLUMNS) * cell_height,
+            surfaces[i] ? surfaces[i]->w : 0,
+            surfaces[i] ? surfaces[i]->h : 0
+        };
+        if (sheet && surfaces[i]) {
+            SDL_BlitSurface(surfaces[i], NULL, sheet, &cell);
+        }
+        atlas->glyphs[i].rect = (SDL_FRect){cell.x, cell.y, cell.w, cell.h};
+        SDL_DestroySurface(surfaces[i]);
+    }
+
+    if (!sheet) {
+        SDL_Log("Failed to create glyph atlas: %s\n", SDL_GetError());
+        return false;
+    }
+
+    Texture_initFromSurface(&atlas->texture, renderer, sheet, "glyph atlas");
+    SDL_DestroySurface(sheet);
+    atlas->height = cell_height;
+    return atlas->texture.texture != NULL;
+}
+
+void GlyphAtlas_destroy(GlyphAtlas* atlas) {
+    if (atlas->texture.texture) {
+        Texture_destroy(&atlas->texture);
+        atlas->texture.texture = NULL;
+    }
+}
+
+const Glyph* GlyphAtlas_get(const GlyphAtlas* atlas, char c) {
+    if (c < GLYPH_ATLAS_FIRST || c > GLYPH_ATLAS_LAST) {
+        c = '?';
+    }
+    return &atlas->glyphs[c - GLYPH_ATLAS_FIRST];
+}
@@ -0,0 +1,38 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include "texture.h"
+
+#include <SDL3/SDL.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include <stdbool.h>
+
+// Printable ASCII range stored in the atlas.
+#define GLYPH_ATLAS_FIRST 32
+#define GLYPH_ATLAS_LAST  126
+#define GLYPH_ATLAS_COUNT (GLYPH_ATLAS_LAST - GLYPH_ATLAS_FIRST + 1)
+
+// Location of a glyph in the atlas texture.
+typedef struct {
+    SDL_FRect rect;
+} Glyph;
+
+// All printable glyphs of a font rasterized once into a single texture.
+// Glyphs are white so they can be tinted with any color.
+typedef struct {
+    Texture texture;
+    Glyph glyphs[GLYPH_ATLAS_COUNT];
+    int height;
+} GlyphAtlas;
+
+// Rasterize the glyphs of the font and upload them as one texture.
+bool GlyphAtlas_init(GlyphAtlas* atlas, SDL_Renderer* renderer, TTF_Font* font);
+
+// Free the atlas texture.
+void GlyphAtlas_destroy(GlyphAtlas* atlas);
+
+// Metrics of a character, characters outside the atlas map to '?'.
+const Glyph* GlyphAtlas_get(const GlyphAtlas* atlas, char c);
+
+#endif
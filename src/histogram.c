@@ -0,0 +1,91 @@
+#include "histogram.h"
+
+#include <string.h>
+
+// Values below 2^bits get their own bucket, above that each power of two is
+// split into HISTOGRAM_HALF_BUCKETS linear sub-buckets.
+static int bucketIndex(uint64_t value) {
+    if (value < (1 << HISTOGRAM_SUB_BUCKET_BITS)) {
+        return (int)value;
+    }
+    int msb = 63;
+    while (!(value >> msb)) {
+        msb--;
+    }
+    int shift = msb - HISTOGRAM_SUB_BUCKET_BITS + 1;
+    return shift * HISTOGRAM_HALF_BUCKETS + (int)(value >> shift);
+}
+
+// Middle of the range of values counted in the bucket, which halves the
+// worst case error compared to either end.
+static uint64_t bucketValue(int index) {
+    if (index < (1 << HISTOGRAM_SUB_BUCKET_BITS)) {
+        return (uint64_t)index;
+    }
+    int shift = index / HISTOGRAM_HALF_BUCKETS - 1;
+    uint64_t top = (uint64_t)(index - shift * HISTOGRAM_HALF_BUCKETS);
+    uint64_t low = top << shift;
+    uint64_t high = ((top + 1) << shift) - 1;
+    return low + (high - low) / 2;
+}
+
+void Histogram_init(Histogram* histogram) {
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min = UINT64_MAX;
+}
+
+void Histogram_record(Histogram* histogram, uint64_t value) {
+    histogram->counts[bucketIndex(value)]++;
+    histogram->total++;
+    if (value < histogram->min) {
+        histogram->min = value;
+    }
+    if (value > histogram->max) {
+        histogram->max = value;
+    }
+}
+
+void Histogram_merge(Histogram* histogram, const Histogram* other) {
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        histogram->counts[i] += other->counts[i];
+    }
+    histogram->total += other->total;
+    if (other->min < histogram->min) {
+        histogram->min = other->min;
+    }
+    if (other->max > histogram->max) {
+        histogram->max = other->max;
+    }
+}
+
+uint64_t Histogram_percentile(const Histogram* histogram, double percentile) {
+    if (histogram->total == 0) {
+        return 0;
+    }
+
+    // The extremes are known exactly.
+    if (percentile <= 0.0) {
+        return histogram->min;
+    }
+    uint64_t rank = (uint64_t)(percentile / 100.0 * histogram->total + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank >= histogram->total) {
+        return histogram->max;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        seen += histogram->counts[i];
+        if (seen >= rank) {
+            // No recorded value lies outside [min, max].
+            uint64_t value = bucketValue(i);
+            if (value < histogram->min) {
+                return histogram->min;
+            }
+            return value > histogram->max ? histogram->max : value;
+        }
+    }
+    return histogram->max;
+}
@@ -0,0 +1,33 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+// Sub-buckets per power of two, sets the precision to about 3 %.
+#define HISTOGRAM_SUB_BUCKET_BITS 6
+#define HISTOGRAM_HALF_BUCKETS    (1 << (HISTOGRAM_SUB_BUCKET_BITS - 1))
+#define HISTOGRAM_BUCKETS         ((66 - HISTOGRAM_SUB_BUCKET_BITS) * HISTOGRAM_HALF_BUCKETS)
+
+// HDR-style log-linear histogram of non-negative integers. Memory is
+// constant and histograms can be merged by adding their counts.
+typedef struct {
+    uint64_t counts[HISTOGRAM_BUCKETS];
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+} Histogram;
+
+// Initialize an empty histogram.
+void Histogram_init(Histogram* histogram);
+
+// Count a value.
+void Histogram_record(Histogram* histogram, uint64_t value);
+
+// Add the counts of another histogram.
+void Histogram_merge(Histogram* histogram, const Histogram* other);
+
+// Value at the percentile (0-100), the middle of its bucket clamped to the
+// recorded range. Returns 0 for an empty histogram.
+uint64_t Histogram_percentile(const Histogram* histogram, double percentile);
+
+#endif
@@ -0,0 +1,127 @@
+#include "input.h"
+
+#include "log.h"
+
+#include <string.h>
+
+// Keys the game loop handles itself.
+static bool isControlKey(SDL_Keycode key) {
+    return key == SDLK_ESCAPE || key == SDLK_F3 || key == SDLK_F12 || key == SDLK_LGUI || key == SDLK_RGUI;
+}
+
+// Called with the mutex held, which keeps producers apart.
+static void push(Input* input, const InputKey* key) {
+    Uint32 head = SDL_GetAtomicU32(&input->head);
+    if (head - SDL_GetAtomicU32(&input->tail) == INPUT_QUEUE_SIZE) {
+        SDL_AddAtomicInt(&input->dropped, 1);
+        return;
+    }
+    input->keys[head % INPUT_QUEUE_SIZE] = *key;
+    SDL_SetAtomicU32(&input->head, head + 1);
+}
+
+// Score a key of the active round. Called with the mutex held.
+static void scoreKey(Input* input, uint64_t timestamp_ns, int keycode) {
+    InputKey scored = {timestamp_ns, input->core->checkIndex, GAME_CORE_KEY_IGNORED, false};
+    scored.result = GameCore_feedKey(input->core, timestamp_ns, keycode);
+    if (scored.result == GAME_CORE_KEY_IGNORED) {
+        return;
+    }
+
+    // The round is over, the core belongs to the game loop until the next one.
+    scored.finished = GameCore_finished(input->core);
+    if (scored.finished) {
+        input->active = false;
+    }
+    push(input, &scored);
+}
+
+// Runs on the thread that pushes the event, before it is queued.
+static bool inputWatch(void* data, SDL_Event* e) {
+    Input* input = data;
+    if (e->type != SDL_EVENT_KEY_DOWN || isControlKey(e->key.key)) {
+        return true;
+    }
+
+    // SDL timestamps are monotonic nanoseconds.
+    SDL_Keycode key = e->key.key;
+    int keycode = key == SDLK_LSHIFT || key == SDLK_RSHIFT ? GAME_CORE_KEY_SHIFT : (int)key;
+
+    SDL_LockMutex(input->mutex);
+    if (input->active) {
+        scoreKey(input, e->key.timestamp, keycode);
+    }
+    else if (input->pending_count < INPUT_PENDING_SIZE) {
+        input->pending[input->pending_count++] = (InputPendingKey){e->key.timestamp, keycode};
+    }
+    else {
+        SDL_AddAtomicInt(&input->dropped, 1);
+    }
+    SDL_UnlockMutex(input->mutex);
+    return true;
+}
+
+bool Input_init(Input* input, GameCore* core) {
+    input->core = core;
+    input->active = false;
+    input->pending_count = 0;
+    SDL_SetAtomicU32(&input->head, 0);
+    SDL_SetAtomicU32(&input->tail, 0);
+    SDL_SetAtomicInt(&input->dropped, 0);
+
+    input->mutex = SDL_CreateMutex();
+    if (!input->mutex) {
+        SDL_Log("Failed to create input mutex: %s\n", SDL_GetError());
+        return false;
+    }
+    if (!SDL_AddEventWatch(inputWatch, input)) {
+        SDL_Log("Failed to watch key presses: %s\n", SDL_GetError());
+        SDL_DestroyMutex(input->mutex);
+        input->mutex = NULL;
+        return false;
+    }
+    return true;
+}
+
+void Input_startRound(Input* input, const char* text, size_t length, uint64_t timestamp_ns) {
+    SDL_LockMutex(input->mutex);
+
+    // Keys typed before the round was shown still count towards its time.
+    if (input->pending_count > 0 && input->pending[0].timestamp_ns < timestamp_ns) {
+        timestamp_ns = input->pending[0].timestamp_ns;
+    }
+    GameCore_startRound(input->core, text, length, timestamp_ns);
+    input->active = true;
+
+    // A short round can finish on pending keys, the rest wait for the next.
+    int scored = 0;
+    while (scored < input->pending_count && input->active) {
+        scoreKey(input, input->pending[scored].timestamp_ns, input->pending[scored].keycode);
+        scored++;
+    }
+    input->pending_count -= scored;
+    memmove(input->pending, input->pending + scored, sizeof(InputPendingKey) * input->pending_count);
+    SDL_UnlockMutex(input->mutex);
+}
+
+bool Input_poll(Input* input, InputKey* key) {
+    int dropped = SDL_GetAtomicInt(&input->dropped);
+    if (dropped > 0) {
+        SDL_AddAtomicInt(&input->dropped, -dropped);
+        LOG_WARN("Input: dropped %d keys\n", dropped);
+    }
+
+    Uint32 tail = SDL_GetAtomicU32(&input->tail);
+    if (tail == SDL_GetAtomicU32(&input->head)) {
+        return false;
+    }
+    *key = input->keys[tail % INPUT_QUEUE_SIZE];
+    SDL_SetAtomicU32(&input->tail, tail + 1);
+    return true;
+}
+
+void Input_destroy(Input* input) {
+    SDL_RemoveEventWatch(inputWatch, input);
+    SDL_DestroyMutex(input->mutex);
+    input->mutex = NULL;
+}
@@ -0,0 +1,69 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "game_core.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Scored keys waiting for the game loop.
+#define INPUT_QUEUE_SIZE 1024
+
+// Keys typed between the finishing key of a round and the start of the next.
+#define INPUT_PENDING_SIZE 64
+
+// A key scored by the event watch.
+typedef struct {
+    uint64_t timestamp_ns;
+    size_t index;
+    GameCoreKeyResult result;
+    bool finished;
+} InputKey;
+
+// A key press waiting for the next round.
+typedef struct {
+    uint64_t timestamp_ns;
+    int keycode;
+} InputPendingKey;
+
+// Scores key presses in an SDL event watch, as soon as SDL receives them
+// instead of when the game loop gets to them. The results go through a
+// single-producer single-consumer ring to the game loop, which only paints
+// them.
+//
+// The watch owns the core while a round is active. After the finishing key
+// the game loop may read the core until Input_startRound, and keys typed in
+// between are kept and scored against the next round.
+typedef struct {
+    GameCore* core;
+
+    // Guards the core, active and the pending keys. Producers of the ring
+    // hold it, the consumer doesn't need it.
+    SDL_Mutex* mutex;
+    bool active;
+    InputPendingKey pending[INPUT_PENDING_SIZE];
+    int pending_count;
+
+    InputKey keys[INPUT_QUEUE_SIZE];
+    SDL_AtomicU32 head;
+    SDL_AtomicU32 tail;
+    SDL_AtomicInt dropped;
+} Input;
+
+// Start watching key presses for the core.
+bool Input_init(Input* input, GameCore* core);
+
+// Start a round on the core, score the keys typed since the last one and
+// hand the core to the watch.
+void Input_startRound(Input* input, const char* text, size_t length, uint64_t timestamp_ns);
+
+// Take the oldest scored key. Returns false if there is none.
+bool Input_poll(Input* input, InputKey* key);
+
+// Stop watching key presses.
+void Input_destroy(Input* input);
+
+#endif
@@ -0,0 +1,38 @@
+#include "latency.h"
+
+#include "log.h"
+
+void Latency_init(Latency* latency) {
+    Histogram_init(&latency->histogram);
+    latency->pending_count = 0;
+}
+
+void Latency_keyPressed(Latency* latency, uint64_t timestamp_ns) {
+    // Keys beyond the limit in a single frame aren't measured.
+    if (latency->pending_count < LATENCY_MAX_PENDING) {
+        latency->pending[latency->pending_count++] = timestamp_ns;
+    }
+}
+
+void Latency_framePresented(Latency* latency, uint64_t timestamp_ns) {
+    for (int i = 0; i < latency->pending_count; i++) {
+        uint64_t pressed = latency->pending[i];
+        Histogram_record(&latency->histogram, timestamp_ns > pressed ? timestamp_ns - pressed : 0);
+    }
+    latency->pending_count = 0;
+}
+
+void Latency_print(const Latency* latency) {
+    const Histogram* histogram = &latency->histogram;
+    if (histogram->total == 0) {
+        LOG_INFO("Input latency: no keys measured\n");
+        return;
+    }
+
+    LOG_INFO("Input latency over %llu keys: p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+           (unsigned long long)histogram->total,
+           Histogram_percentile(histogram, 50.0) / 1e6,
+           Histogram_percentile(histogram, 90.0) / 1e6,
+           Histogram_percentile(histogram, 99.0) / 1e6,
+           histogram->max / 1e6);
+}
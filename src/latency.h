@@ -0,0 +1,31 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include "histogram.h"
+
+#include <stdint.h>
+
+// Keys waiting for the frame that shows them.
+#define LATENCY_MAX_PENDING 64
+
+// Measures the time from a key press to the present of the first frame
+// showing its result.
+typedef struct {
+    Histogram histogram;
+    uint64_t pending[LATENCY_MAX_PENDING];
+    int pending_count;
+} Latency;
+
+// Initialize with an empty histogram.
+void Latency_init(Latency* latency);
+
+// A key with the SDL event timestamp was handled.
+void Latency_keyPressed(Latency* latency, uint64_t timestamp_ns);
+
+// A frame was presented at the time, completing every pending key.
+void Latency_framePresented(Latency* latency, uint64_t timestamp_ns);
+
+// Print the latency percentiles.
+void Latency_print(const Latency* latency);
+
+#endif
@@ -0,0 +1,170 @@
+#include "log.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_RING_SIZE    1024
+#define LOG_MESSAGE_SIZE 160
+#define LOG_MAX_THREADS  8
+
+typedef struct {
+    int level;
+    char text[LOG_MESSAGE_SIZE];
+} LogEntry;
+
+// Single-producer single-consumer ring. Only the owning thread moves head and
+// only the log thread moves tail.
+typedef struct {
+    LogEntry entries[LOG_RING_SIZE];
+    SDL_AtomicU32 head;
+    SDL_AtomicU32 tail;
+    SDL_AtomicInt dropped;
+} LogRing;
+
+static struct {
+    LogRing* rings[LOG_MAX_THREADS];
+    SDL_AtomicInt ring_count;
+    SDL_Mutex* register_mutex;
+    SDL_Semaphore* wake;
+    SDL_Thread* thread;
+    SDL_AtomicInt running;
+} logger;
+
+static _Thread_local LogRing* thread_ring;
+
+static void writeEntry(int level, const char* text) {
+    FILE* out = level >= LOG_LEVEL_WARN ? stderr : stdout;
+    fputs(text, out);
+}
+
+// Write everything queued so far. Returns the number of messages written.
+static int drainRings(void) {
+    int written = 0;
+    int count = SDL_GetAtomicInt(&logger.ring_count);
+    for (int i = 0; i < count; i++) {
+        LogRing* ring = logger.rings[i];
+        Uint32 tail = SDL_GetAtomicU32(&ring->tail);
+        Uint32 head = SDL_GetAtomicU32(&ring->head);
+
+        while (tail != head) {
+            LogEntry* entry = &ring->entries[tail % LOG_RING_SIZE];
+            writeEntry(entry->level, entry->text);
+            tail++;
+            written++;
+        }
+        SDL_SetAtomicU32(&ring->tail, tail);
+
+        int dropped = SDL_GetAtomicInt(&ring->dropped);
+        if (dropped > 0) {
+            SDL_AddAtomicInt(&ring->dropped, -dropped);
+            fprintf(stderr, "Log: dropped %d messages\n", dropped);
+        }
+    }
+    if (written > 0) {
+        fflush(stdout);
+    }
+    return written;
+}
+
+static int logThread(void* data) {
+    (void)data;
+    while (SDL_GetAtomicInt(&logger.running)) {
+        if (drainRings() == 0) {
+            SDL_WaitSemaphoreTimeout(logger.wake, 100);
+        }
+    }
+    drainRings();
+    return 0;
+}
+
+// Ring of the calling thread, registered on its first message.
+static LogRing* threadRing(void) {
+    if (thread_ring) {
+        return thread_ring;
+    }
+
+    SDL_LockMutex(logger.register_mutex);
+    int count = SDL_GetAtomicInt(&logger.ring_count);
+    if (count < LOG_MAX_THREADS) {
+        LogRing* ring = calloc(1, sizeof(LogRing));
+        if (ring) {
+            logger.rings[count] = ring;
+            SDL_SetAtomicInt(&logger.ring_count, count + 1);
+            thread_ring = ring;
+        }
+    }
+    SDL_UnlockMutex(logger.register_mutex);
+    return thread_ring;
+}
+
+void Log_init(void) {
+    logger.register_mutex = SDL_CreateMutex();
+    logger.wake = SDL_CreateSemaphore(0);
+    if (!logger.register_mutex || !logger.wake) {
+        return;
+    }
+
+    SDL_SetAtomicInt(&logger.running, 1);
+    logger.thread = SDL_CreateThread(logThread, "log", NULL);
+    if (!logger.thread) {
+        SDL_SetAtomicInt(&logger.running, 0);
+    }
+}
+
+void Log_quit(void) {
+    if (logger.thread) {
+        SDL_SetAtomicInt(&logger.running, 0);
+        SDL_SignalSemaphore(logger.wake);
+        SDL_WaitThread(logger.thread, NULL);
+        logger.thread = NULL;
+    }
+
+    int count = SDL_GetAtomicInt(&logger.ring_count);
+    SDL_SetAtomicInt(&logger.ring_count, 0);
+    for (int i = 0; i < count; i++) {
+        free(logger.rings[i]);
+        logger.rings[i] = NULL;
+    }
+    thread_ring = NULL;
+
+    SDL_DestroySemaphore(logger.wake);
+    SDL_DestroyMutex(logger.register_mutex);
+    logger.wake = NULL;
+    logger.register_mutex = NULL;
+}
+
+void Log_write(int level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    LogRing* ring = SDL_GetAtomicInt(&logger.running) ? threadRing() : NULL;
+    if (!ring) {
+        vfprintf(level >= LOG_LEVEL_WARN ? stderr : stdout, format, args);
+        va_end(args);
+        return;
+    }
+
+    Uint32 head = SDL_GetAtomicU32(&ring->head);
+    Uint32 tail = SDL_GetAtomicU32(&ring->tail);
+    if (head - tail >= LOG_RING_SIZE) {
+        SDL_AddAtomicInt(&ring->dropped, 1);
+        va_end(args);
+        return;
+    }
+
+    LogEntry* entry = &ring->entries[head % LOG_RING_SIZE];
+    entry->level = level;
+    vsnprintf(entry->text, sizeof(entry->text), format, args);
+    va_end(args);
+
+    // Publishing the head makes the entry visible to the log thread.
+    SDL_SetAtomicU32(&ring->head, head + 1);
+
+    // Only wake the log thread when it may be waiting on an empty ring.
+    if (head == tail) {
+        SDL_SignalSemaphore(logger.wake);
+    }
+}
@@ -1,8 +1,10 @@
 #include "game.h"
+#include "log.h"
+#include "perf_stats.h"
 
 int main(int argc, char** argv) {
-    (void)argc;
-    (void)argv;
+    // Allocation counting has to be in place before SDL allocates anything.
+    PerfStats_init();
 
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         SDL_Log("SDL could not initialize! SDL Error: %s\n", SDL_GetError());
@@ -15,16 +17,23 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    Log_init();
+
     Game game;
-    Game_init(&game);
+    if (!Game_init(&game, argc, argv)) {
+        Log_quit();
+        TTF_Quit();
+        SDL_Quit();
+        return 1;
+    }
     Game_setup(&game);
 
     while (!game.close) {
         Game_update(&game);
-        SDL_Delay(16); // 60 fps
     }
 
     Game_destroy(&game);
+    Log_quit();
     TTF_Quit();
     SDL_Quit();
 
@@ -0,0 +1,86 @@
+#include "perf_hud.h"
+#include "perf_stats.h"
+#include "texture_registry.h"
+
+#include <stdio.h>
+
+#define PERF_HUD_PADDING 8
+#define PERF_HUD_LINES 5
+#define PERF_HUD_GRAPH_HEIGHT 60
+// Frame time at the top of the graph.
+#define PERF_HUD_GRAPH_MAX_MS 33.3f
+
+static const SDL_Color textColor = {255, 255, 255, 255};
+
+static float addLine(PerfHud* hud, const GlyphAtlas* atlas, const char* text, float x, float y) {
+    float width = 0.0f;
+    for (const char* c = text; *c; c++) {
+        TextBatch_add(&hud->batch, atlas, *c, x + width, y, textColor);
+        width += GlyphAtlas_get(atlas, *c)->rect.w;
+    }
+    return width;
+}
+
+void PerfHud_init(PerfHud* hud) {
+    hud->visible = false;
+    TextBatch_init(&hud->batch);
+}
+
+void PerfHud_render(PerfHud* hud, SDL_Renderer* renderer, GlyphAtlas* atlas, const Latency* latency, int x, int y) {
+    if (!hud->visible) {
+        return;
+    }
+
+    const PerfStats* stats = PerfStats_get();
+    const TextureRegistry* textures = TextureRegistry_get();
+    int last = (stats->frame_index + PERF_STATS_FRAMES - 1) % PERF_STATS_FRAMES;
+    double p50 = latency->histogram.total > 0 ? Histogram_percentile(&latency->histogram, 50.0) / 1e6 : 0.0;
+    double p99 = latency->histogram.total > 0 ? Histogram_percentile(&latency->histogram, 99.0) / 1e6 : 0.0;
+
+    char lines[PERF_HUD_LINES][64];
+    snprintf(lines[0], sizeof(lines[0]), "frame: %.2f ms", stats->frame_ms[last]);
+    snprintf(lines[1], sizeof(lines[1]), "draw calls: %d", stats->draw_calls);
+    snprintf(lines[2], sizeof(lines[2]), "textures: %d (%.2f MB)", textures->count, textures->bytes / (1024.0 * 1024.0));
+    snprintf(lines[3], sizeof(lines[3]), "SDL allocations: %d", stats->allocations);
+    snprintf(lines[4], sizeof(lines[4]), "latency p50 / p99: %.1f / %.1f ms", p50, p99);
+
+    TextBatch_clear(&hud->batch);
+    float text_x = x + PERF_HUD_PADDING;
+    float text_y = y + PERF_HUD_PADDING;
+    float width = PERF_STATS_FRAMES * 2;
+    for (int i = 0; i < PERF_HUD_LINES; i++) {
+        float line_width = addLine(hud, atlas, lines[i], text_x, text_y);
+        if (line_width > width) {
+            width = line_width;
+        }
+        text_y += atlas->height;
+    }
+
+    // Translucent background behind the text and the graph.
+    SDL_FRect background = {x, y, width + PERF_HUD_PADDING * 2, text_y - y + PERF_HUD_GRAPH_HEIGHT + PERF_HUD_PADDING * 2};
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180);
+    SDL_RenderFillRect(renderer, &background);
+    PerfStats_drawCall();
+
+    TextBatch_render(&hud->batch, renderer, atlas);
+
+    // Frame times from oldest to newest, two pixels apart.
+    SDL_FPoint points[PERF_STATS_FRAMES];
+    float bottom = text_y + PERF_HUD_PADDING + PERF_HUD_GRAPH_HEIGHT;
+    for (int i = 0; i < PERF_STATS_FRAMES; i++) {
+        float ms = stats->frame_ms[(stats->frame_index + i) % PERF_STATS_FRAMES];
+        if (ms > PERF_HUD_GRAPH_MAX_MS) {
+            ms = PERF_HUD_GRAPH_MAX_MS;
+        }
+        points[i].x = text_x + i * 2;
+        points[i].y = bottom - ms / PERF_HUD_GRAPH_MAX_MS * PERF_HUD_GRAPH_HEIGHT;
+    }
+    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
+    SDL_RenderLines(renderer, points, PERF_STATS_FRAMES);
+    PerfStats_drawCall();
+}
+
+void PerfHud_destroy(PerfHud* hud) {
+    TextBatch_destroy(&hud->batch);
+}
@@ -0,0 +1,28 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include "glyph_atlas.h"
+#include "text_batch.h"
+#include "latency.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+// Overlay with the frame time graph, draw calls, live textures, SDL heap
+// allocations and input latency.
+typedef struct {
+    bool visible;
+    TextBatch batch;
+} PerfHud;
+
+// Initialize a hidden HUD.
+void PerfHud_init(PerfHud* hud);
+
+// Draw the HUD with its top left corner at the position, if it's visible.
+void PerfHud_render(PerfHud* hud, SDL_Renderer* renderer, GlyphAtlas* atlas, const Latency* latency, int x, int y);
+
+// Free the text buffers.
+void PerfHud_destroy(PerfHud* hud);
+
+#endif
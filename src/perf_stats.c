@@ -0,0 +1,55 @@
+#include "perf_stats.h"
+
+#include <SDL3/SDL.h>
+
+static PerfStats stats;
+
+// SDL allocates on its own threads too.
+static SDL_AtomicInt allocations;
+static SDL_malloc_func originalMalloc;
+static SDL_calloc_func originalCalloc;
+static SDL_realloc_func originalRealloc;
+
+static void* countingMalloc(size_t size) {
+    SDL_AddAtomicInt(&allocations, 1);
+    return originalMalloc(size);
+}
+
+static void* countingCalloc(size_t count, size_t size) {
+    SDL_AddAtomicInt(&allocations, 1);
+    return originalCalloc(count, size);
+}
+
+static void* countingRealloc(void* memory, size_t size) {
+    SDL_AddAtomicInt(&allocations, 1);
+    return originalRealloc(memory, size);
+}
+
+void PerfStats_init(void) {
+    SDL_free_func originalFree;
+    SDL_GetOriginalMemoryFunctions(&originalMalloc, &originalCalloc, &originalRealloc, &originalFree);
+    if (!SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc, originalFree)) {
+        SDL_Log("Failed to count allocations: %s\n", SDL_GetError());
+    }
+}
+
+const PerfStats* PerfStats_get(void) {
+    return &stats;
+}
+
+void PerfStats_drawCall(void) {
+    stats.frame_draw_calls++;
+}
+
+void PerfStats_beginFrame(uint64_t timestamp_ns) {
+    stats.frame_start_ns = timestamp_ns;
+    stats.frame_draw_calls = 0;
+    stats.frame_allocations_start = SDL_GetAtomicInt(&allocations);
+}
+
+void PerfStats_endFrame(uint64_t timestamp_ns) {
+    stats.frame_ms[stats.frame_index] = (float)((timestamp_ns - stats.frame_start_ns) / 1e6);
+    stats.frame_index = (stats.frame_index + 1) % PERF_STATS_FRAMES;
+    stats.draw_calls = stats.frame_draw_calls;
+    stats.allocations = SDL_GetAtomicInt(&allocations) - stats.frame_allocations_start;
+}
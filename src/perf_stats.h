@@ -0,0 +1,38 @@
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <stdint.h>
+
+// Frames kept for the frame time graph.
+#define PERF_STATS_FRAMES 120
+
+// Counters fed by the render and window code, read by the performance HUD.
+typedef struct {
+    // Time from clearing to presenting each frame, frame_ms[frame_index] is
+    // the oldest.
+    float frame_ms[PERF_STATS_FRAMES];
+    int frame_index;
+
+    // Last presented frame.
+    int draw_calls;
+    int allocations;
+
+    // Frame in progress.
+    uint64_t frame_start_ns;
+    int frame_draw_calls;
+    int frame_allocations_start;
+} PerfStats;
+
+// Count SDL heap allocations. Must run before SDL_Init.
+void PerfStats_init(void);
+
+// Counters of the whole program.
+const PerfStats* PerfStats_get(void);
+
+void PerfStats_drawCall(void);
+
+// Bracket a frame, from clearing the window to presenting it.
+void PerfStats_beginFrame(uint64_t timestamp_ns);
+void PerfStats_endFrame(uint64_t timestamp_ns);
+
+#endif
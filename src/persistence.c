@@ -0,0 +1,169 @@
+#include "persistence.h"
+
+#include "log.h"
+#include "trace.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static char* copyPath(const char* path) {
+    if (!path) {
+        return NULL;
+    }
+    size_t length = strlen(path) + 1;
+    char* copy = malloc(length);
+    if (copy) {
+        memcpy(copy, path, length);
+    }
+    return copy;
+}
+
+static bool hasPending(const Persistence* persistence) {
+    return persistence->count > 0 || persistence->metrics_pending || persistence->bigrams_pending;
+}
+
+// Write one batch of results, skipping files without a path and snapshots
+// that are NULL.
+static void writeResults(const Persistence* persistence, const SessionRecord* records, size_t count,
+                         const GameMetrics* metrics, const BigramMatrix* bigrams) {
+    TRACE_BEGIN("persist");
+    if (count > 0 && persistence->sessions_path && !SessionStore_appendBatch(persistence->sessions_path, records, count)) {
+        LOG_ERROR("Failed to store %zu rounds in %s\n", count, persistence->sessions_path);
+    }
+    if (metrics && persistence->percentiles_path && !GameMetrics_saveSketch(metrics, persistence->percentiles_path)) {
+        LOG_ERROR("Failed to store percentiles in %s\n", persistence->percentiles_path);
+    }
+    if (bigrams && persistence->bigrams_path && !TypingStats_saveBigrams(bigrams, persistence->bigrams_path)) {
+        LOG_ERROR("Failed to store bigrams in %s\n", persistence->bigrams_path);
+    }
+    TRACE_END("persist");
+}
+
+static int persistenceWorker(void* data) {
+    Persistence* persistence = data;
+
+    SDL_LockMutex(persistence->mutex);
+    while (true) {
+        while (!persistence->quit && !hasPending(persistence)) {
+            SDL_WaitCondition(persistence->condition, persistence->mutex);
+        }
+        if (!hasPending(persistence)) {
+            break;
+        }
+
+        // Take everything queued so far and write it without holding the lock.
+        SessionRecord* records = persistence->records;
+        size_t capacity = persistence->capacity;
+        size_t count = persistence->count;
+        persistence->records = persistence->writing;
+        persistence->capacity = persistence->writing_capacity;
+        persistence->count = 0;
+        persistence->writing = records;
+        persistence->writing_capacity = capacity;
+
+        bool write_metrics = persistence->metrics_pending;
+        if (write_metrics) {
+            persistence->metrics_snapshot = persistence->metrics;
+            persistence->metrics_pending = false;
+        }
+
+        bool write_bigrams = persistence->bigrams_pending;
+        if (write_bigrams) {
+            BigramMatrix* bigrams = persistence->bigrams;
+            persistence->bigrams = persistence->bigrams_snapshot;
+            persistence->bigrams_snapshot = bigrams;
+            persistence->bigrams_pending = false;
+        }
+        SDL_UnlockMutex(persistence->mutex);
+
+        writeResults(persistence, persistence->writing, count, write_metrics ? &persistence->metrics_snapshot : NULL,
+                     write_bigrams ? persistence->bigrams_snapshot : NULL);
+
+        SDL_LockMutex(persistence->mutex);
+    }
+    SDL_UnlockMutex(persistence->mutex);
+    return 0;
+}
+
+bool Persistence_init(Persistence* persistence, const char* sessions_path, const char* percentiles_path, const char* bigrams_path) {
+    memset(persistence, 0, sizeof(*persistence));
+    persistence->sessions_path = copyPath(sessions_path);
+    persistence->percentiles_path = copyPath(percentiles_path);
+    persistence->bigrams_path = copyPath(bigrams_path);
+    GameMetrics_init(&persistence->metrics);
+    GameMetrics_init(&persistence->metrics_snapshot);
+
+    persistence->bigrams = malloc(sizeof(BigramMatrix));
+    persistence->bigrams_snapshot = malloc(sizeof(BigramMatrix));
+    if (!persistence->bigrams || !persistence->bigrams_snapshot) {
+        LOG_ERROR("Memory allocation for the persistence queue failed.\n");
+        return false;
+    }
+
+    persistence->mutex = SDL_CreateMutex();
+    persistence->condition = SDL_CreateCondition();
+    if (!persistence->mutex || !persistence->condition) {
+        SDL_Log("Failed to create persistence worker: %s\n", SDL_GetError());
+        return false;
+    }
+
+    persistence->thread = SDL_CreateThread(persistenceWorker, "persistence", persistence);
+    if (!persistence->thread) {
+        SDL_Log("Failed to create persistence thread: %s\n", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+void Persistence_submitRound(Persistence* persistence, const SessionRecord* record, const GameMetrics* metrics, const BigramMatrix* bigrams) {
+    // Without the worker the round is written right away, so it's never lost.
+    if (!persistence->thread) {
+        writeResults(persistence, record, 1, metrics, bigrams);
+        return;
+    }
+
+    SDL_LockMutex(persistence->mutex);
+    if (persistence->count == persistence->capacity) {
+        size_t capacity = persistence->capacity ? persistence->capacity * 2 : 16;
+        SessionRecord* records = realloc(persistence->records, sizeof(SessionRecord) * capacity);
+        if (records) {
+            persistence->records = records;
+            persistence->capacity = capacity;
+        }
+    }
+    if (persistence->count < persistence->capacity) {
+        persistence->records[persistence->count++] = *record;
+    } else {
+        LOG_ERROR("Memory allocation for the persistence queue failed.\n");
+    }
+
+    persistence->metrics = *metrics;
+    persistence->metrics_pending = true;
+    if (bigrams) {
+        memcpy(persistence->bigrams, bigrams, sizeof(BigramMatrix));
+        persistence->bigrams_pending = true;
+    }
+    SDL_SignalCondition(persistence->condition);
+    SDL_UnlockMutex(persistence->mutex);
+}
+
+void Persistence_destroy(Persistence* persistence) {
+    if (persistence->thread) {
+        SDL_LockMutex(persistence->mutex);
+        persistence->quit = true;
+        SDL_SignalCondition(persistence->condition);
+        SDL_UnlockMutex(persistence->mutex);
+        SDL_WaitThread(persistence->thread, NULL);
+        persistence->thread = NULL;
+    }
+
+    SDL_DestroyCondition(persistence->condition);
+    SDL_DestroyMutex(persistence->mutex);
+    free(persistence->records);
+    free(persistence->writing);
+    free(persistence->bigrams);
+    free(persistence->bigrams_snapshot);
+    free(persistence->sessions_path);
+    free(persistence->percentiles_path);
+    free(persistence->bigrams_path);
+}
@@ -0,0 +1,53 @@
+#ifndef PERSISTENCE_H
+#define PERSISTENCE_H
+
+#include "session_store.h"
+#include "game_metrics.h"
+#include "typing_stats.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+// Writes round results on a worker thread so the game thread never waits on
+// the disk. Records are appended in batches, snapshots replace their files
+// atomically and only the latest one is written.
+typedef struct {
+    SDL_Thread* thread;
+    SDL_Mutex* mutex;
+    SDL_Condition* condition;
+
+    // Resolved once in Persistence_init.
+    char* sessions_path;
+    char* percentiles_path;
+    char* bigrams_path;
+
+    // Guarded by the mutex.
+    SessionRecord* records;
+    size_t count;
+    size_t capacity;
+    GameMetrics metrics;
+    bool metrics_pending;
+    BigramMatrix* bigrams;
+    bool bigrams_pending;
+    bool quit;
+
+    // Used only by the worker.
+    SessionRecord* writing;
+    size_t writing_capacity;
+    GameMetrics metrics_snapshot;
+    BigramMatrix* bigrams_snapshot;
+} Persistence;
+
+// Start the worker. Any path may be NULL to skip that file. Returns false if
+// the worker couldn't start, rounds are then written on the calling thread.
+bool Persistence_init(Persistence* persistence, const char* sessions_path, const char* percentiles_path, const char* bigrams_path);
+
+// Queue a finished round with the metrics and bigram history after it.
+// Bigrams may be NULL.
+void Persistence_submitRound(Persistence* persistence, const SessionRecord* record, const GameMetrics* metrics, const BigramMatrix* bigrams);
+
+// Write everything still queued and stop the worker.
+void Persistence_destroy(Persistence* persistence);
+
+#endif
@@ -0,0 +1,138 @@
+#include "pipeline.h"
+
+#include "trace.h"
+
+#include <string.h>
+
+void Round_init(Round* round) {
+    Sentence_init(&round->sentence);
+    Arena_init(&round->arena);
+    round->glyphs = NULL;
+    round->colors = NULL;
+    round->positions = NULL;
+}
+
+void Round_destroy(Round* round) {
+    Arena_destroy(&round->arena);
+    Sentence_destroy(&round->sentence);
+    Round_init(round);
+}
+
+// Drop the previous round's data and allocate room for length glyphs. Once
+// the arena fits the longest sentence this never allocates.
+static bool reserveRound(Round* round, size_t length) {
+    size_t size = Arena_size(length) + Arena_size(sizeof(SDL_Color) * length) + Arena_size(sizeof(SDL_FPoint) * length);
+    if (!Arena_reset(&round->arena, size)) {
+        return false;
+    }
+    round->glyphs = Arena_alloc(&round->arena, length);
+    round->colors = Arena_alloc(&round->arena, sizeof(SDL_Color) * length);
+    round->positions = Arena_alloc(&round->arena, sizeof(SDL_FPoint) * length);
+    return true;
+}
+
+// Build the next sentence and its initial glyphs and colors.
+static void prepareRound(Pipeline* pipeline) {
+    Round* round = &pipeline->next;
+    size_t length = Word_getSentence(pipeline->word, pipeline->random, pipeline->total_words, &round->sentence);
+
+    if (length == 0 || !reserveRound(round, length)) {
+        Sentence_clear(&round->sentence);
+        return;
+    }
+
+    memcpy(round->glyphs, round->sentence.data, length);
+    for (size_t i = 0; i < length; i++) {
+        round->colors[i] = pipeline->color;
+    }
+}
+
+static int pipelineWorker(void* data) {
+    Pipeline* pipeline = data;
+
+    SDL_LockMutex(pipeline->mutex);
+    while (!pipeline->quit) {
+        if (pipeline->ready) {
+            SDL_WaitCondition(pipeline->condition, pipeline->mutex);
+            continue;
+        }
+        SDL_UnlockMutex(pipeline->mutex);
+
+        TRACE_BEGIN("prepareRound");
+        prepareRound(pipeline);
+        TRACE_END("prepareRound");
+
+        SDL_LockMutex(pipeline->mutex);
+        pipeline->ready = true;
+        SDL_BroadcastCondition(pipeline->condition);
+    }
+    SDL_UnlockMutex(pipeline->mutex);
+    return 0;
+}
+
+bool Pipeline_init(Pipeline* pipeline, Word* word, Random* random, int total_words, SDL_Color color) {
+    pipeline->word = word;
+    pipeline->random = random;
+    pipeline->total_words = total_words;
+    pipeline->color = color;
+    pipeline->ready = false;
+    pipeline->quit = false;
+    pipeline->thread = NULL;
+    Round_init(&pipeline->next);
+
+    pipeline->mutex = SDL_CreateMutex();
+    pipeline->condition = SDL_CreateCondition();
+    if (!pipeline->mutex || !pipeline->condition) {
+        SDL_Log("Failed to create round pipeline: %s\n", SDL_GetError());
+        return false;
+    }
+
+    pipeline->thread = SDL_CreateThread(pipelineWorker, "round pipeline", pipeline);
+    if (!pipeline->thread) {
+        SDL_Log("Failed to create round pipeline thread: %s\n", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+bool Pipeline_swap(Pipeline* pipeline, Round* current) {
+    if (!pipeline->thread) {
+        return false;
+    }
+
+    SDL_LockMutex(pipeline->mutex);
+    while (!pipeline->ready) {
+        SDL_WaitCondition(pipeline->condition, pipeline->mutex);
+    }
+    SDL_UnlockMutex(pipeline->mutex);
+
+    if (pipeline->next.sentence.length == 0) {
+        return false;
+    }
+
+    // The old round's buffers are reused for the one after this.
+    Round previous = *current;
+    *current = pipeline->next;
+    pipeline->next = previous;
+
+    SDL_LockMutex(pipeline->mutex);
+    pipeline->ready = false;
+    SDL_BroadcastCondition(pipeline->condition);
+    SDL_UnlockMutex(pipeline->mutex);
+    return true;
+}
+
+void Pipeline_destroy(Pipeline* pipeline) {
+    if (pipeline->thread) {
+        SDL_LockMutex(pipeline->mutex);
+        pipeline->quit = true;
+        SDL_BroadcastCondition(pipeline->condition);
+        SDL_UnlockMutex(pipeline->mutex);
+        SDL_WaitThread(pipeline->thread, NULL);
+        pipeline->thread = NULL;
+    }
+    Round_destroy(&pipeline->next);
+
+    SDL_DestroyCondition(pipeline->condition);
+    SDL_DestroyMutex(pipeline->mutex);
+}
@@ -0,0 +1,59 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "arena.h"
+#include "sentence.h"
+#include "word.h"
+#include "random.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+// Sentence and displayed glyphs of a single round. The glyphs, colors and
+// layout positions are allocated from the round's arena.
+typedef struct {
+    Sentence sentence;
+    Arena arena;
+    char* glyphs;
+    SDL_Color* colors;
+    SDL_FPoint* positions;
+} Round;
+
+// Prepares the next round on a worker thread while the current one is typed.
+typedef struct {
+    SDL_Thread* thread;
+    SDL_Mutex* mutex;
+    SDL_Condition* condition;
+
+    // Used only by the worker after Pipeline_init.
+    Word* word;
+    Random* random;
+    int total_words;
+    SDL_Color color;
+
+    // The prepared round.
+    Round next;
+
+    // Guarded by the mutex.
+    bool ready;
+    bool quit;
+} Pipeline;
+
+// Initialize an empty round.
+void Round_init(Round* round);
+
+// Free the buffers of a round.
+void Round_destroy(Round* round);
+
+// Start the worker and begin preparing the first round.
+bool Pipeline_init(Pipeline* pipeline, Word* word, Random* random, int total_words, SDL_Color color);
+
+// Replace current with the prepared round, waiting for it if needed, and start
+// preparing the next one. Returns false if no round could be built.
+bool Pipeline_swap(Pipeline* pipeline, Round* current);
+
+// Stop the worker and free the prepared round.
+void Pipeline_destroy(Pipeline* pipeline);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+// xoshiro256** generator state. Every session owns its own state so results
+// can be reproduced from the seed.
+typedef struct {
+    uint64_t state[4];
+    uint64_t seed;
+} Random;
+
+// Seed the generator.
+void Random_init(Random* random, uint64_t seed);
+
+// Seed that differs between runs, for when no seed is configured.
+uint64_t Random_timeSeed(void);
+
+// Next 64 random bits.
+uint64_t Random_next(Random* random);
+
+// Uniform number in [0, bound) without modulo bias. Bound must not be 0.
+uint32_t Random_bounded(Random* random, uint32_t bound);
+
+#endif
@@ -0,0 +1,61 @@
+#include "sentence.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void Sentence_init(Sentence* sentence) {
+    sentence->data = NULL;
+    sentence->length = 0;
+    sentence->capacity = 0;
+}
+
+bool Sentence_reserve(Sentence* sentence, size_t capacity) {
+    if (capacity < sentence->capacity) {
+        return true;
+    }
+
+    // Grow geometrically so appending stays linear.
+    size_t new_capacity = sentence->capacity > 0 ? sentence->capacity * 2 : 64;
+    while (new_capacity <= capacity) {
+        new_capacity *= 2;
+    }
+
+    char* data = realloc(sentence->data, new_capacity);
+    if (!data) {
+        fprintf(stderr, "Memory allocation for sentence failed.\n");
+        return false;
+    }
+    if (!sentence->data) {
+        data[0] = '\0';
+    }
+    sentence->data = data;
+    sentence->capacity = new_capacity;
+    return true;
+}
+
+bool Sentence_append(Sentence* sentence, const char* text, size_t length) {
+    if (!Sentence_reserve(sentence, sentence->length + length)) {
+        return false;
+    }
+    memcpy(sentence->data + sentence->length, text, length);
+    sentence->length += length;
+    sentence->data[sentence->length] = '\0';
+    return true;
+}
+
+bool Sentence_appendChar(Sentence* sentence, char c) {
+    return Sentence_append(sentence, &c, 1);
+}
+
+void Sentence_clear(Sentence* sentence) {
+    sentence->length = 0;
+    if (sentence->data) {
+        sentence->data[0] = '\0';
+    }
+}
+
+void Sentence_destroy(Sentence* sentence) {
+    free(sentence->data);
+    Sentence_init(sentence);
+}
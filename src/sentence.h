@@ -0,0 +1,32 @@
+#ifndef SENTENCE_H
+#define SENTENCE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Growable, null-terminated text buffer. The write cursor is the length.
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} Sentence;
+
+// Initialize an empty sentence.
+void Sentence_init(Sentence* sentence);
+
+// Make room for capacity characters and the terminator.
+bool Sentence_reserve(Sentence* sentence, size_t capacity);
+
+// Append length characters of text at the write cursor.
+bool Sentence_append(Sentence* sentence, const char* text, size_t length);
+
+// Append a single character at the write cursor.
+bool Sentence_appendChar(Sentence* sentence, char c);
+
+// Reset the write cursor, keeping the buffer for reuse.
+void Sentence_clear(Sentence* sentence);
+
+// Free the buffer.
+void Sentence_destroy(Sentence* sentence);
+
+#endif
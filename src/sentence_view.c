@@ -0,0 +1,20 @@
+#include "sentence_view.h"
+
+void SentenceView_render(TextLayout* layout, SDL_FPoint* positions, TextBatch* batch, GlyphAtlas* atlas,
+                         SDL_Renderer* renderer, const char* text, const char* glyphs, const SDL_Color* colors,
+                         size_t length, int width) {
+    int xpadding = 100;
+    int ypadding = xpadding * 4;
+    int maxLineWidth = width - xpadding * 2;
+
+    const SDL_FPoint* placed = TextLayout_update(layout, positions, atlas, text, length, xpadding, ypadding,
+                                                 maxLineWidth, xpadding);
+
+    TextBatch_clear(batch);
+    for (size_t i = 0; i < layout->count; i++) {
+        TextBatch_add(batch, atlas, glyphs[i], placed[i].x, placed[i].y, colors[i]);
+    }
+
+    // Draw the whole sentence in one call.
+    TextBatch_render(batch, renderer, atlas);
+}
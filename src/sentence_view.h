@@ -0,0 +1,19 @@
+#ifndef SENTENCE_VIEW_H
+#define SENTENCE_VIEW_H
+
+#include "glyph_atlas.h"
+#include "text_batch.h"
+#include "text_layout.h"
+
+#include <SDL3/SDL.h>
+
+#include <stddef.h>
+
+// Lay out the sentence in a window of the given width and draw it in one
+// call. The layout follows text, while glyphs and colors are what's drawn,
+// so a typed space keeps its place as '_'. All arrays hold length entries.
+void SentenceView_render(TextLayout* layout, SDL_FPoint* positions, TextBatch* batch, GlyphAtlas* atlas,
+                         SDL_Renderer* renderer, const char* text, const char* glyphs, const SDL_Color* colors,
+                         size_t length, int width);
+
+#endif
@@ -0,0 +1,219 @@
+#include "session_store.h"
+
+#include "atomic_file.h"
+
+#include "log.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#define SESSION_FILE_MAGIC   "TTSESSN"
+#define SESSION_FILE_VERSION 1
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+} SessionFileHeader;
+
+static bool headerMatches(const SessionFileHeader* header) {
+    return memcmp(header->magic, SESSION_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == SESSION_FILE_VERSION && header->record_size == sizeof(SessionRecord);
+}
+
+bool SessionStore_open(SessionStore* store, const char* file_path) {
+    store->records = NULL;
+    store->count = 0;
+
+    if (!FileMap_open(&store->file, file_path)) {
+        // No rounds were played yet.
+        return errno == ENOENT;
+    }
+    // An empty file or a torn header from an interrupted first append holds
+    // no rounds.
+    if (store->file.size < sizeof(SessionFileHeader)) {
+        return true;
+    }
+
+    const SessionFileHeader* header = (const SessionFileHeader*)store->file.data;
+    if (!headerMatches(header)) {
+        fprintf(stderr, "Unknown session file format in %s\n", file_path);
+        FileMap_close(&store->file);
+        return false;
+    }
+
+    // A torn record at the end from an interrupted append is ignored.
+    store->records = (const SessionRecord*)(store->file.data + sizeof(SessionFileHeader));
+    store->count = (store->file.size - sizeof(SessionFileHeader)) / sizeof(SessionRecord);
+    return true;
+}
+
+void SessionStore_close(SessionStore* store) {
+    FileMap_close(&store->file);
+    store->records = NULL;
+    store->count = 0;
+}
+
+// Cut the file to size bytes, dropping what an interrupted append left.
+static bool truncateFile(FILE* file, long size) {
+    fflush(file);
+#ifdef _WIN32
+    return _chsize(_fileno(file), size) == 0;
+#else
+    return ftruncate(fileno(file), (off_t)size) == 0;
+#endif
+}
+
+bool SessionStore_appendBatch(const char* file_path, const SessionRecord* records, size_t count) {
+    FILE* file = fopen(file_path, "r+b");
+    if (!file && errno == ENOENT) {
+        file = fopen(file_path, "w+b");
+    }
+    if (!file) {
+        perror("Failed to open session file");
+        return false;
+    }
+
+    bool ok = true;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    long header_size = (long)sizeof(SessionFileHeader);
+
+    if (size >= header_size) {
+        SessionFileHeader header;
+        rewind(file);
+        if (fread(&header, sizeof(header), 1, file) != 1 || !headerMatches(&header)) {
+            fprintf(stderr, "Unknown session file format in %s\n", file_path);
+            fclose(file);
+            return false;
+        }
+
+        // Records after a torn one would be misaligned, so the torn bytes go.
+        long torn = (size - header_size) % (long)sizeof(SessionRecord);
+        if (torn != 0) {
+            fprintf(stderr, "Dropping a partial record at the end of %s\n", file_path);
+            size -= torn;
+            ok = truncateFile(file, size);
+        }
+    }
+    else if (size > 0) {
+        fprintf(stderr, "Rewriting the partial header of %s\n", file_path);
+        size = 0;
+        ok = truncateFile(file, size);
+    }
+
+    ok = ok && fseek(file, size, SEEK_SET) == 0;
+    if (ok && size == 0) {
+        SessionFileHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, SESSION_FILE_MAGIC, sizeof(header.magic));
+        header.version = SESSION_FILE_VERSION;
+        header.record_size = sizeof(SessionRecord);
+        ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    // Records reach the disk before the call returns, a crash can at worst
+    // leave a torn last record, which reads skip and the next append drops.
+    ok = ok && fwrite(records, sizeof(SessionRecord), count, file) == count;
+    ok = ok && AtomicFile_sync(file);
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        perror("Failed to write session record");
+    }
+    return ok;
+}
+
+bool SessionStore_append(const char* file_path, const SessionRecord* record) {
+    return SessionStore_appendBatch(file_path, record, 1);
+}
+
+// Keep an imported legacy file next to its old name instead of deleting it.
+static void retireLegacyFile(const char* file_path) {
+    char imported[512];
+    snprintf(imported, sizeof(imported), "%s.imported", file_path);
+    if (!AtomicFile_replace(file_path, imported)) {
+        LOG_WARN("Could not rename %s, it will be imported again\n", file_path);
+    }
+}
+
+size_t SessionStore_importLegacy(const char* file_path, const char* speed_path, const char* accuracy_path) {
+    FILE* speed = speed_path ? fopen(speed_path, "r") : NULL;
+    if (!speed) {
+        return 0;
+    }
+
+    // Rounds played since the upgrade win, the old files are left alone.
+    SessionStore store;
+    if (!SessionStore_open(&store, file_path)) {
+        fclose(speed);
+        return 0;
+    }
+    size_t existing = store.count;
+    SessionStore_close(&store);
+    if (existing > 0) {
+        fclose(speed);
+        return 0;
+    }
+
+    // Both files got one line per round, a missing accuracy counts as 0.
+    FILE* accuracy = accuracy_path ? fopen(accuracy_path, "r") : NULL;
+    SessionRecord* records = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+    bool ok = true;
+    double wpm;
+    while (ok && fscanf(speed, "%lf", &wpm) == 1) {
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 256;
+            SessionRecord* grown = realloc(records, sizeof(SessionRecord) * capacity);
+            if (!grown) {
+                LOG_ERROR("Memory allocation for the history import failed.\n");
+                ok = false;
+                break;
+            }
+            records = grown;
+        }
+        double value = 0.0;
+        if (accuracy && fscanf(accuracy, "%lf", &value) != 1) {
+            value = 0.0;
+        }
+        records[count] = (SessionRecord){
+            .timestamp = 0,
+            .wpm = wpm,
+            .accuracy = value,
+            .duration = 0.0,
+            .seed = 0,
+            .round = (uint32_t)count,
+            .word_count = 0,
+        };
+        count++;
+    }
+    fclose(speed);
+    if (accuracy) {
+        fclose(accuracy);
+    }
+
+    ok = ok && (count == 0 || SessionStore_appendBatch(file_path, records, count));
+    free(records);
+    if (!ok) {
+        LOG_ERROR("Failed to import the old history into %s\n", file_path);
+        return 0;
+    }
+
+    retireLegacyFile(speed_path);
+    if (accuracy) {
+        retireLegacyFile(accuracy_path);
+    }
+    LOG_INFO("Imported %zu rounds from %s\n", count, speed_path);
+    return count;
+}
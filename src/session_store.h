@@ -0,0 +1,49 @@
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include "file_map.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Result of a single round. Records are fixed-size and only ever appended.
+typedef struct {
+    // Unix time at the end of the round.
+    int64_t timestamp;
+    double wpm;
+    double accuracy;
+    double duration;
+    // Session seed and the round number in the session, enough to replay it.
+    uint64_t seed;
+    uint32_t round;
+    uint32_t word_count;
+} SessionRecord;
+
+// Read-only view of every stored round.
+typedef struct {
+    FileMap file;
+    const SessionRecord* records;
+    size_t count;
+} SessionStore;
+
+// Map the session file. A missing or empty file gives an empty store.
+bool SessionStore_open(SessionStore* store, const char* file_path);
+
+// Unmap the session file.
+void SessionStore_close(SessionStore* store);
+
+// Append a record to the session file, writing the header to a new file.
+// A partial header or record left by an interrupted append is cut off first.
+bool SessionStore_append(const char* file_path, const SessionRecord* record);
+
+// Append count records with a single write and sync them to disk.
+bool SessionStore_appendBatch(const char* file_path, const SessionRecord* records, size_t count);
+
+// Import the speed and accuracy files of older versions, one number per
+// round, into a session file without rounds. Only speed and accuracy are
+// known. The old files are renamed with a ".imported" suffix so it happens
+// once. Returns the number of imported rounds.
+size_t SessionStore_importLegacy(const char* file_path, const char* speed_path, const char* accuracy_path);
+
+#endif
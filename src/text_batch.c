@@ -0,0 +1,97 @@
+#include "text_batch.h"
+
+#include "perf_stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+void TextBatch_init(TextBatch* batch) {
+    batch->vertices = NULL;
+    batch->indices = NULL;
+    batch->count = 0;
+    batch->capacity = 0;
+}
+
+void TextBatch_clear(TextBatch* batch) {
+    batch->count = 0;
+}
+
+// Grow the buffers. The index pattern never changes, so it's written here once.
+static bool reserveBatch(TextBatch* batch, int capacity) {
+    if (capacity <= batch->capacity) {
+        return true;
+    }
+
+    int new_capacity = batch->capacity > 0 ? batch->capacity * 2 : 64;
+    while (new_capacity < capacity) {
+        new_capacity *= 2;
+    }
+
+    SDL_Vertex* vertices = realloc(batch->vertices, sizeof(SDL_Vertex) * 4 * new_capacity);
+    if (vertices) {
+        batch->vertices = vertices;
+    }
+    int* indices = realloc(batch->indices, sizeof(int) * 6 * new_capacity);
+    if (indices) {
+        batch->indices = indices;
+    }
+    if (!vertices || !indices) {
+        fprintf(stderr, "Memory allocation for text batch failed.\n");
+        return false;
+    }
+
+    for (int i = batch->capacity; i < new_capacity; i++) {
+        int* quad = &batch->indices[i * 6];
+        int first = i * 4;
+        quad[0] = first;
+        quad[1] = first + 1;
+        quad[2] = first + 2;
+        quad[3] = first;
+        quad[4] = first + 2;
+        quad[5] = first + 3;
+    }
+    batch->capacity = new_capacity;
+    return true;
+}
+
+bool TextBatch_add(TextBatch* batch, const GlyphAtlas* atlas, char c, float x, float y, SDL_Color color) {
+    // Spaces have nothing to draw.
+    if (c == ' ') {
+        return true;
+    }
+    if (!reserveBatch(batch, batch->count + 1)) {
+        return false;
+    }
+
+    const SDL_FRect* rect = &GlyphAtlas_get(atlas, c)->rect;
+    float u0 = rect->x / atlas->texture.width;
+    float v0 = rect->y / atlas->texture.height;
+    float u1 = (rect->x + rect->w) / atlas->texture.width;
+    float v1 = (rect->y + rect->h) / atlas->texture.height;
+    SDL_FColor fcolor = {color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f};
+
+    SDL_Vertex* quad = &batch->vertices[batch->count * 4];
+    quad[0] = (SDL_Vertex){{x, y}, fcolor, {u0, v0}};
+    quad[1] = (SDL_Vertex){{x + rect->w, y}, fcolor, {u1, v0}};
+    quad[2] = (SDL_Vertex){{x + rect->w, y + rect->h}, fcolor, {u1, v1}};
+    quad[3] = (SDL_Vertex){{x, y + rect->h}, fcolor, {u0, v1}};
+    batch->count++;
+    return true;
+}
+
+void TextBatch_render(TextBatch* batch, SDL_Renderer* renderer, GlyphAtlas* atlas) {
+    if (batch->count == 0) {
+        return;
+    }
+
+    // Vertex colors carry the tint, the texture itself must stay white.
+    SDL_SetTextureColorMod(atlas->texture.texture, 255, 255, 255);
+    SDL_RenderGeometry(renderer, atlas->texture.texture, batch->vertices, batch->count * 4, batch->indices, batch->count * 6);
+    PerfStats_drawCall();
+}
+
+void TextBatch_destroy(TextBatch* batch) {
+    free(batch->vertices);
+    free(batch->indices);
+    TextBatch_init(batch);
+}
@@ -0,0 +1,35 @@
+#ifndef TEXT_BATCH_H
+#define TEXT_BATCH_H
+
+#include "glyph_atlas.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+
+// Glyph quads collected into one vertex and index buffer, drawn with a single
+// SDL_RenderGeometry call. Colors are per vertex, so no color mod changes
+// are needed between glyphs.
+typedef struct {
+    SDL_Vertex* vertices;
+    int* indices;
+    int count;
+    int capacity;
+} TextBatch;
+
+// Initialize an empty batch.
+void TextBatch_init(TextBatch* batch);
+
+// Remove all glyphs, keeping the buffers.
+void TextBatch_clear(TextBatch* batch);
+
+// Add a glyph quad with its top left corner at the position.
+bool TextBatch_add(TextBatch* batch, const GlyphAtlas* atlas, char c, float x, float y, SDL_Color color);
+
+// Draw all glyphs of the batch.
+void TextBatch_render(TextBatch* batch, SDL_Renderer* renderer, GlyphAtlas* atlas);
+
+// Free the buffers.
+void TextBatch_destroy(TextBatch* batch);
+
+#endif
@@ -0,0 +1,62 @@
+#include "text_layout.h"
+
+void TextLayout_init(TextLayout* layout) {
+    layout->positions = NULL;
+    layout->count = 0;
+    layout->dirty = true;
+}
+
+void TextLayout_invalidate(TextLayout* layout) {
+    layout->dirty = true;
+}
+
+static int glyphWidth(const GlyphAtlas* atlas, char c) {
+    return (int)GlyphAtlas_get(atlas, c)->rect.w;
+}
+
+// Width of the word starting at text[start].
+static int wordWidth(const GlyphAtlas* atlas, const char* text, size_t start, size_t length) {
+    int width = 0;
+    for (size_t i = start; i < length && text[i] != ' '; i++) {
+        width += glyphWidth(atlas, text[i]);
+    }
+    return width;
+}
+
+const SDL_FPoint* TextLayout_update(TextLayout* layout, SDL_FPoint* positions, const GlyphAtlas* atlas, const char* text,
+                                    size_t length, int x, int y, int max_width, int line_height) {
+    if (!layout->dirty && layout->positions == positions && layout->count == length) {
+        return layout->positions;
+    }
+    layout->positions = positions;
+
+    int currentX = x;
+    int currentY = y;
+    int right = x + max_width;
+
+    for (size_t i = 0; i < length; i++) {
+        int w = glyphWidth(atlas, text[i]);
+        bool wordStart = text[i] != ' ' && (i == 0 || text[i - 1] == ' ');
+
+        // Move the whole word to the next line if it doesn't fit. Words wider
+        // than a line are split where they overflow.
+        if (currentX > x) {
+            if ((wordStart && currentX + wordWidth(atlas, text, i, length) > right) ||
+                (!wordStart && currentX + w > right)) {
+                currentX = x;
+                currentY += line_height;
+            }
+        }
+
+        layout->positions[i] = (SDL_FPoint){currentX, currentY};
+        currentX += w;
+    }
+
+    layout->count = length;
+    layout->dirty = false;
+    return layout->positions;
+}
+
+void TextLayout_destroy(TextLayout* layout) {
+    TextLayout_init(layout);
+}
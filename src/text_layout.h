@@ -0,0 +1,35 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include "glyph_atlas.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Cached position of every glyph in the sentence. Lines are wrapped at word
+// boundaries. The layout is recomputed only after it's invalidated by a
+// resize or a new sentence. The positions are stored by the caller.
+typedef struct {
+    SDL_FPoint* positions;
+    size_t count;
+    bool dirty;
+} TextLayout;
+
+// Initialize an empty layout.
+void TextLayout_init(TextLayout* layout);
+
+// Mark the layout to be recomputed on the next update.
+void TextLayout_invalidate(TextLayout* layout);
+
+// Positions of the glyphs of text, starting from (x, y) and wrapping lines
+// wider than max_width, written to positions which must hold length points.
+// Only recomputed if the layout is dirty or the storage changed.
+const SDL_FPoint* TextLayout_update(TextLayout* layout, SDL_FPoint* positions, const GlyphAtlas* atlas, const char* text,
+                                    size_t length, int x, int y, int max_width, int line_height);
+
+// Forget the positions.
+void TextLayout_destroy(TextLayout* layout);
+
+#endif
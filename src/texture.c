@@ -1,36 +1,48 @@
 #include "texture.h"
+#include "texture_registry.h"
+
+#include "perf_stats.h"
+
+// Upload the surface through the registry, leaving an empty texture if it
+// fails.
+static void createFromSurface(Texture* texture, SDL_Renderer* renderer, SDL_Surface* surface, const char* label) {
+    texture->texture = TextureRegistry_create(renderer, surface, label);
+    texture->width = texture->texture ? surface->w : 0;
+    texture->height = texture->texture ? surface->h : 0;
+}
 
 void Texture_init(Texture* texture, SDL_Renderer* renderer, TTF_Font* font, const char* word, SDL_Color color) {
     SDL_Surface* surface = TTF_RenderText_Solid(font, word, strlen(word), color);
-    texture->texture = SDL_CreateTextureFromSurface(renderer, surface);
-    float w, h;
-    SDL_GetTextureSize(texture->texture, &w, &h);
-    texture->width = (int)w;
-    texture->height = (int)h;
+    createFromSurface(texture, renderer, surface, word);
     SDL_DestroySurface(surface);
 }
 
+void Texture_initFromSurface(Texture* texture, SDL_Renderer* renderer, SDL_Surface* surface, const char* label) {
+    createFromSurface(texture, renderer, surface, label);
+}
+
 void Texture_destroy(Texture* tex) {
-    SDL_DestroyTexture(tex->texture);
+    TextureRegistry_destroy(tex->texture);
+    tex->texture = NULL;
 }
 
 void Texture_render(Texture* tex, SDL_Renderer* renderer, int x, int y, SDL_Color color) {
+    if (!tex->texture) {
+        return;
+    }
     SDL_SetTextureColorMod(tex->texture, color.r, color.g, color.b);
     SDL_FRect renderQuad = {x, y, tex->width, tex->height};
     SDL_RenderTexture(renderer, tex->texture, NULL, &renderQuad);
+    PerfStats_drawCall();
 }
 
 void createTexture(Texture* texture, SDL_Renderer* renderer, TTF_Font* font, char* text, SDL_Color color) {
     // Destroy the previous texture
-    if (texture->texture) {
-        SDL_DestroyTexture(texture->texture);
-    }
+    Texture_destroy(texture);
 
     // Create a new surface and texture with the updated character
     SDL_Surface* surface = TTF_RenderText_Solid(font, text, strlen(text), color);
-    texture->texture = SDL_CreateTextureFromSurface(renderer, surface);
-    texture->width = surface->w;
-    texture->height = surface->h;
+    createFromSurface(texture, renderer, surface, text);
 
     // Free the temporary surface
     SDL_DestroySurface(surface);
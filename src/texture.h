@@ -11,6 +11,7 @@ typedef struct {
 } Texture;
 
 void Texture_init(Texture* texture, SDL_Renderer* renderer, TTF_Font* font, const char* word, SDL_Color color);
+void Texture_initFromSurface(Texture* texture, SDL_Renderer* renderer, SDL_Surface* surface, const char* label);
 void Texture_destroy(Texture* texture);
 void Texture_render(Texture* texture, SDL_Renderer* renderer, int x, int y, SDL_Color color);
 void Texture_update(Texture* texture, SDL_Renderer* renderer, TTF_Font* font, char* newChars, SDL_Color color);
@@ -0,0 +1,97 @@
+#include "texture_registry.h"
+#include "log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static TextureRegistry registry;
+
+static bool reserve(void) {
+    if (registry.count < registry.capacity) {
+        return true;
+    }
+    int capacity = registry.capacity > 0 ? registry.capacity * 2 : 64;
+    TextureRegistryEntry* entries = realloc(registry.entries, sizeof(TextureRegistryEntry) * capacity);
+    if (!entries) {
+        return false;
+    }
+    registry.entries = entries;
+    registry.capacity = capacity;
+    return true;
+}
+
+void TextureRegistry_setBudget(int64_t bytes) {
+    registry.budget = bytes > 0 ? bytes : 0;
+}
+
+SDL_Texture* TextureRegistry_create(SDL_Renderer* renderer, SDL_Surface* surface, const char* label) {
+    if (!surface) {
+        LOG_ERROR("No surface for texture \"%s\": %s\n", label, SDL_GetError());
+        return NULL;
+    }
+    if (!reserve()) {
+        LOG_ERROR("Memory allocation for texture registry failed.\n");
+        return NULL;
+    }
+
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+    if (!texture) {
+        LOG_ERROR("Failed to create texture \"%s\": %s\n", label, SDL_GetError());
+        return NULL;
+    }
+
+    // The texture format is what the GPU holds, which can be wider than the
+    // surface.
+    int64_t bytes = (int64_t)texture->w * texture->h * SDL_BYTESPERPIXEL(texture->format);
+    if (registry.budget > 0 && registry.bytes + bytes > registry.budget) {
+        LOG_ERROR("Texture \"%s\" of %lld bytes would exceed the budget of %lld bytes (%lld in use).\n", label,
+                  (long long)bytes, (long long)registry.budget, (long long)registry.bytes);
+        SDL_DestroyTexture(texture);
+        return NULL;
+    }
+
+    TextureRegistryEntry* entry = &registry.entries[registry.count++];
+    entry->texture = texture;
+    entry->bytes = bytes;
+    snprintf(entry->label, sizeof(entry->label), "%s", label);
+    registry.bytes += bytes;
+    if (registry.bytes > registry.peak_bytes) {
+        registry.peak_bytes = registry.bytes;
+    }
+    return texture;
+}
+
+void TextureRegistry_destroy(SDL_Texture* texture) {
+    if (!texture) {
+        return;
+    }
+    // Recent textures are replaced most often, search from the end.
+    for (int i = registry.count - 1; i >= 0; i--) {
+        if (registry.entries[i].texture == texture) {
+            registry.bytes -= registry.entries[i].bytes;
+            registry.entries[i] = registry.entries[--registry.count];
+            SDL_DestroyTexture(texture);
+            return;
+        }
+    }
+    LOG_ERROR("Destroying a texture that isn't registered.\n");
+    SDL_DestroyTexture(texture);
+}
+
+const TextureRegistry* TextureRegistry_get(void) {
+    return &registry;
+}
+
+int TextureRegistry_quit(void) {
+    int leaked = registry.count;
+    LOG_INFO("Textures: peak %.2f MB\n", registry.peak_bytes / (1024.0 * 1024.0));
+    if (leaked > 0) {
+        LOG_WARN("%d textures (%lld bytes) were never destroyed:\n", leaked, (long long)registry.bytes);
+        for (int i = 0; i < leaked; i++) {
+            LOG_WARN("  \"%s\" %lld bytes\n", registry.entries[i].label, (long long)registry.entries[i].bytes);
+        }
+    }
+    free(registry.entries);
+    registry = (TextureRegistry){0};
+    return leaked;
+}
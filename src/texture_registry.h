@@ -0,0 +1,47 @@
+#ifndef TEXTURE_REGISTRY_H
+#define TEXTURE_REGISTRY_H
+
+#include <SDL3/SDL.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Longest label kept for a texture, longer ones are cut.
+#define TEXTURE_REGISTRY_LABEL 32
+
+typedef struct {
+    SDL_Texture* texture;
+    int64_t bytes;
+    char label[TEXTURE_REGISTRY_LABEL];
+} TextureRegistryEntry;
+
+// Every live texture with its size in bytes, so textures that are never
+// destroyed show up at shutdown.
+typedef struct {
+    TextureRegistryEntry* entries;
+    int count;
+    int capacity;
+    int64_t bytes;
+    int64_t peak_bytes;
+    // 0 means no limit.
+    int64_t budget;
+} TextureRegistry;
+
+// Limit the bytes of all live textures, 0 removes the limit.
+void TextureRegistry_setBudget(int64_t bytes);
+
+// Create a texture from the surface and track it under the label. Returns
+// NULL if it can't be created or would go over the budget.
+SDL_Texture* TextureRegistry_create(SDL_Renderer* renderer, SDL_Surface* surface, const char* label);
+
+// Destroy a texture created by the registry.
+void TextureRegistry_destroy(SDL_Texture* texture);
+
+// Live textures and their totals.
+const TextureRegistry* TextureRegistry_get(void);
+
+// Print the totals and every texture that is still alive, then free the
+// registry. Returns the number of leaked textures.
+int TextureRegistry_quit(void);
+
+#endif
@@ -0,0 +1,216 @@
+#include "trace.h"
+
+#include <SDL3/SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TRACE_RING_SIZE   8192
+#define TRACE_MAX_THREADS 8
+#define TRACE_MAX_DEPTH   64
+
+typedef struct {
+    const char* name;
+    Uint64 timestamp_ns;
+    char phase;
+} TraceEvent;
+
+// Single-producer single-consumer ring, like the log rings.
+typedef struct {
+    TraceEvent events[TRACE_RING_SIZE];
+    SDL_ThreadID thread_id;
+    SDL_AtomicU32 head;
+    SDL_AtomicU32 tail;
+    SDL_AtomicInt dropped;
+
+    // Only touched by the producer. Zones are dropped whole: an 'E' is kept
+    // only if its 'B' was, and every kept 'B' reserves a slot for its 'E'.
+    bool kept[TRACE_MAX_DEPTH];
+    int depth;
+    int open;
+} TraceRing;
+
+static struct {
+    TraceRing* rings[TRACE_MAX_THREADS];
+    SDL_AtomicInt ring_count;
+    SDL_Mutex* register_mutex;
+    SDL_Semaphore* wake;
+    SDL_Thread* thread;
+    SDL_AtomicInt running;
+    FILE* file;
+    bool first_event;
+} tracer;
+
+static _Thread_local TraceRing* thread_ring;
+
+static void writeEvent(const TraceRing* ring, const TraceEvent* event) {
+    // Chrome trace timestamps are microseconds.
+    fprintf(tracer.file, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%llu}",
+            tracer.first_event ? "\n" : ",\n", event->name, event->phase, event->timestamp_ns / 1000.0,
+            (unsigned long long)ring->thread_id);
+    tracer.first_event = false;
+}
+
+static int drainRings(void) {
+    int written = 0;
+    int count = SDL_GetAtomicInt(&tracer.ring_count);
+    for (int i = 0; i < count; i++) {
+        TraceRing* ring = tracer.rings[i];
+        Uint32 tail = SDL_GetAtomicU32(&ring->tail);
+        Uint32 head = SDL_GetAtomicU32(&ring->head);
+
+        while (tail != head) {
+            writeEvent(ring, &ring->events[tail % TRACE_RING_SIZE]);
+            tail++;
+            written++;
+        }
+        SDL_SetAtomicU32(&ring->tail, tail);
+
+        int dropped = SDL_GetAtomicInt(&ring->dropped);
+        if (dropped > 0) {
+            SDL_AddAtomicInt(&ring->dropped, -dropped);
+            fprintf(stderr, "Trace: dropped %d events\n", dropped);
+        }
+    }
+    return written;
+}
+
+static int traceThread(void* data) {
+    (void)data;
+    while (SDL_GetAtomicInt(&tracer.running)) {
+        if (drainRings() == 0) {
+            SDL_WaitSemaphoreTimeout(tracer.wake, 50);
+        }
+    }
+    drainRings();
+    return 0;
+}
+
+// Ring of the calling thread, registered on its first event.
+static TraceRing* threadRing(void) {
+    if (thread_ring) {
+        return thread_ring;
+    }
+
+    SDL_LockMutex(tracer.register_mutex);
+    int count = SDL_GetAtomicInt(&tracer.ring_count);
+    if (count < TRACE_MAX_THREADS) {
+        TraceRing* ring = calloc(1, sizeof(TraceRing));
+        if (ring) {
+            ring->thread_id = SDL_GetCurrentThreadID();
+            tracer.rings[count] = ring;
+            SDL_SetAtomicInt(&tracer.ring_count, count + 1);
+            thread_ring = ring;
+        }
+    }
+    SDL_UnlockMutex(tracer.register_mutex);
+    return thread_ring;
+}
+
+bool Trace_init(const char* file_path) {
+    if (!file_path || file_path[0] == '\0') {
+        return false;
+    }
+#if !TRACE_ENABLED
+    fprintf(stderr, "Tracing was disabled at compile time, ignoring %s\n", file_path);
+    return false;
+#endif
+
+    tracer.file = fopen(file_path, "w");
+    if (!tracer.file) {
+        perror("Failed to open trace file");
+        return false;
+    }
+    fputs("{\"traceEvents\":[", tracer.file);
+    tracer.first_event = true;
+
+    tracer.register_mutex = SDL_CreateMutex();
+    tracer.wake = SDL_CreateSemaphore(0);
+    if (!tracer.register_mutex || !tracer.wake) {
+        Trace_quit();
+        return false;
+    }
+
+    SDL_SetAtomicInt(&tracer.running, 1);
+    tracer.thread = SDL_CreateThread(traceThread, "trace", NULL);
+    if (!tracer.thread) {
+        SDL_SetAtomicInt(&tracer.running, 0);
+        Trace_quit();
+        return false;
+    }
+    return true;
+}
+
+void Trace_quit(void) {
+    if (tracer.thread) {
+        SDL_SetAtomicInt(&tracer.running, 0);
+        SDL_SignalSemaphore(tracer.wake);
+        SDL_WaitThread(tracer.thread, NULL);
+        tracer.thread = NULL;
+    }
+
+    int count = SDL_GetAtomicInt(&tracer.ring_count);
+    SDL_SetAtomicInt(&tracer.ring_count, 0);
+    for (int i = 0; i < count; i++) {
+        free(tracer.rings[i]);
+        tracer.rings[i] = NULL;
+    }
+    thread_ring = NULL;
+
+    if (tracer.file) {
+        fputs("\n]}\n", tracer.file);
+        fclose(tracer.file);
+        tracer.file = NULL;
+    }
+    SDL_DestroySemaphore(tracer.wake);
+    SDL_DestroyMutex(tracer.register_mutex);
+    tracer.wake = NULL;
+    tracer.register_mutex = NULL;
+}
+
+void Trace_event(const char* name, char phase) {
+    if (!SDL_GetAtomicInt(&tracer.running)) {
+        return;
+    }
+    TraceRing* ring = threadRing();
+    if (!ring) {
+        return;
+    }
+
+    Uint32 head = SDL_GetAtomicU32(&ring->head);
+    Uint32 tail = SDL_GetAtomicU32(&ring->tail);
+    if (phase == 'B') {
+        bool keep = ring->depth < TRACE_MAX_DEPTH && head - tail + (Uint32)ring->open + 2 <= TRACE_RING_SIZE;
+        if (ring->depth < TRACE_MAX_DEPTH) {
+            ring->kept[ring->depth] = keep;
+        }
+        ring->depth++;
+        if (!keep) {
+            SDL_AddAtomicInt(&ring->dropped, 1);
+            return;
+        }
+        ring->open++;
+    } else {
+        // Its slot was reserved by the 'B', so a kept 'E' always fits.
+        bool keep = ring->depth > 0 && ring->depth <= TRACE_MAX_DEPTH && ring->kept[ring->depth - 1];
+        if (ring->depth > 0) {
+            ring->depth--;
+        }
+        if (!keep) {
+            SDL_AddAtomicInt(&ring->dropped, 1);
+            return;
+        }
+        ring->open--;
+    }
+
+    TraceEvent* event = &ring->events[head % TRACE_RING_SIZE];
+    event->name = name;
+    event->phase = phase;
+    event->timestamp_ns = SDL_GetTicksNS();
+    SDL_SetAtomicU32(&ring->head, head + 1);
+
+    // Wake the trace thread early once the ring is half full.
+    if (head - tail == TRACE_RING_SIZE / 2) {
+        SDL_SignalSemaphore(tracer.wake);
+    }
+}
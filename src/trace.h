@@ -0,0 +1,33 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+
+// Zones are compiled out with -DTRACE_ENABLED=0.
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+// Mark the start and the end of a zone on the calling thread. Zones nest and
+// names must be string literals, only the pointer is stored.
+#if TRACE_ENABLED
+#define TRACE_BEGIN(name) Trace_event(name, 'B')
+#define TRACE_END(name)   Trace_event(name, 'E')
+#else
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name)   ((void)0)
+#endif
+
+// Start writing zones to a Chrome trace file (chrome://tracing, Perfetto).
+// Without a call or with an empty path zones cost a single check.
+bool Trace_init(const char* file_path);
+
+// Write the remaining zones and close the file.
+void Trace_quit(void);
+
+// Queue a zone event with phase 'B' or 'E'. Never blocks: each thread has its
+// own ring buffer and zones are dropped when it's full, always with both of
+// their events so the trace stays balanced.
+void Trace_event(const char* name, char phase);
+
+#endif
@@ -0,0 +1,178 @@
+#include "typing_stats.h"
+
+#include "atomic_file.h"
+#include "log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BIGRAM_FILE_MAGIC   "TTBIGRAM"
+#define BIGRAM_FILE_VERSION 1
+
+// Most transitions TypingStats_printSlowest reports.
+#define SLOWEST_MAX 16
+
+static unsigned char charIndex(char c) {
+    return (unsigned char)c & (TYPING_STATS_CHARS - 1);
+}
+
+bool TypingStats_init(TypingStats* stats) {
+    stats->count = 0;
+    stats->previous = 0;
+    stats->capacity = 256;
+    stats->keys = malloc(sizeof(Keystroke) * stats->capacity);
+    stats->bigrams = calloc(1, sizeof(BigramMatrix));
+    if (!stats->keys || !stats->bigrams) {
+        LOG_ERROR("Memory allocation for typing stats failed.\n");
+        TypingStats_destroy(stats);
+        return false;
+    }
+    return true;
+}
+
+void TypingStats_destroy(TypingStats* stats) {
+    free(stats->keys);
+    free(stats->bigrams);
+    stats->keys = NULL;
+    stats->bigrams = NULL;
+    stats->count = 0;
+    stats->capacity = 0;
+}
+
+void TypingStats_startRound(TypingStats* stats, size_t length) {
+    stats->count = 0;
+    stats->previous = 0;
+
+    // Room for every letter and as many mistakes, so recording never allocates.
+    if (stats->keys && length * 2 > stats->capacity) {
+        Keystroke* keys = realloc(stats->keys, sizeof(Keystroke) * length * 2);
+        if (keys) {
+            stats->keys = keys;
+            stats->capacity = length * 2;
+        }
+    }
+}
+
+void TypingStats_recordKey(TypingStats* stats, uint64_t timestamp_ns, char expected, char typed, bool correct) {
+    if (!stats->keys) {
+        return;
+    }
+
+    // A transition starts from the last correctly typed character and its
+    // latency is the time since the previous key press.
+    if (stats->previous) {
+        unsigned char from = charIndex(stats->previous);
+        unsigned char to = charIndex(expected);
+        if (correct) {
+            uint64_t last = stats->keys[stats->count - 1].timestamp_ns;
+            stats->bigrams->latency_ns[from][to] += timestamp_ns > last ? timestamp_ns - last : 0;
+            stats->bigrams->count[from][to]++;
+        }
+        else {
+            stats->bigrams->errors[from][to]++;
+        }
+    }
+    if (correct) {
+        stats->previous = expected;
+    }
+
+    if (stats->count == stats->capacity) {
+        size_t capacity = stats->capacity * 2;
+        Keystroke* keys = realloc(stats->keys, sizeof(Keystroke) * capacity);
+        if (!keys) {
+            return;
+        }
+        stats->keys = keys;
+        stats->capacity = capacity;
+    }
+    stats->keys[stats->count++] = (Keystroke){timestamp_ns, expected, typed, correct};
+}
+
+bool TypingStats_load(TypingStats* stats, const char* file_path) {
+    FILE* file = fopen(file_path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    char magic[8];
+    uint32_t version;
+    BigramMatrix* stored = malloc(sizeof(BigramMatrix));
+    bool ok = stored &&
+              fread(magic, sizeof(magic), 1, file) == 1 &&
+              fread(&version, sizeof(version), 1, file) == 1 &&
+              memcmp(magic, BIGRAM_FILE_MAGIC, sizeof(magic)) == 0 &&
+              version == BIGRAM_FILE_VERSION &&
+              fread(stored, sizeof(BigramMatrix), 1, file) == 1;
+    fclose(file);
+
+    if (ok) {
+        for (int from = 0; from < TYPING_STATS_CHARS; from++) {
+            for (int to = 0; to < TYPING_STATS_CHARS; to++) {
+                stats->bigrams->latency_ns[from][to] += stored->latency_ns[from][to];
+                stats->bigrams->count[from][to] += stored->count[from][to];
+                stats->bigrams->errors[from][to] += stored->errors[from][to];
+            }
+        }
+    }
+    free(stored);
+    return ok;
+}
+
+bool TypingStats_saveBigrams(const BigramMatrix* bigrams, const char* file_path) {
+    AtomicFile atomic;
+    if (!AtomicFile_open(&atomic, file_path)) {
+        return false;
+    }
+
+    uint32_t version = BIGRAM_FILE_VERSION;
+    bool ok = fwrite(BIGRAM_FILE_MAGIC, 8, 1, atomic.file) == 1 &&
+              fwrite(&version, sizeof(version), 1, atomic.file) == 1 &&
+              fwrite(bigrams, sizeof(BigramMatrix), 1, atomic.file) == 1;
+    return AtomicFile_commit(&atomic, ok);
+}
+
+void TypingStats_printSlowest(const TypingStats* stats, int n) {
+    if (!stats->bigrams || n <= 0) {
+        return;
+    }
+    if (n > SLOWEST_MAX) {
+        n = SLOWEST_MAX;
+    }
+
+    // Keep the n slowest transitions sorted, slowest first.
+    int from_chars[SLOWEST_MAX];
+    int to_chars[SLOWEST_MAX];
+    double averages[SLOWEST_MAX];
+    int found = 0;
+
+    for (int from = ' '; from < TYPING_STATS_CHARS; from++) {
+        for (int to = ' '; to < TYPING_STATS_CHARS; to++) {
+            uint32_t count = stats->bigrams->count[from][to];
+            if (count == 0) {
+                continue;
+            }
+            double average = (double)stats->bigrams->latency_ns[from][to] / count;
+            if (found == n && average <= averages[n - 1]) {
+                continue;
+            }
+
+            int i = found < n ? found++ : n - 1;
+            while (i > 0 && averages[i - 1] < average) {
+                from_chars[i] = from_chars[i - 1];
+                to_chars[i] = to_chars[i - 1];
+                averages[i] = averages[i - 1];
+                i--;
+            }
+            from_chars[i] = from;
+            to_chars[i] = to;
+            averages[i] = average;
+        }
+    }
+
+    // Indexed in place, the log call compiles out with a higher LOG_LEVEL.
+    for (int i = 0; i < found; i++) {
+        LOG_INFO("Slow transition %c%c: %.0f ms over %u, %u errors\n", from_chars[i], to_chars[i], averages[i] / 1e6,
+                 stats->bigrams->count[from_chars[i]][to_chars[i]], stats->bigrams->errors[from_chars[i]][to_chars[i]]);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef TYPING_STATS_H
+#define TYPING_STATS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Characters tracked in the bigram matrix.
+#define TYPING_STATS_CHARS 128
+
+// A single key press of a round.
+typedef struct {
+    uint64_t timestamp_ns;
+    char expected;
+    char typed;
+    bool correct;
+} Keystroke;
+
+// Transition latency and errors between every pair of ASCII characters.
+// Indexed by [previous][next] expected character.
+typedef struct {
+    uint64_t latency_ns[TYPING_STATS_CHARS][TYPING_STATS_CHARS];
+    uint32_t count[TYPING_STATS_CHARS][TYPING_STATS_CHARS];
+    uint32_t errors[TYPING_STATS_CHARS][TYPING_STATS_CHARS];
+} BigramMatrix;
+
+typedef struct {
+    // Key presses of the current round, the buffer is kept between rounds.
+    Keystroke* keys;
+    size_t count;
+    size_t capacity;
+
+    // Last correctly typed character of the round, 0 before the first.
+    char previous;
+
+    // Bigram history of all rounds.
+    BigramMatrix* bigrams;
+} TypingStats;
+
+// Allocate the key buffer and an empty bigram history.
+bool TypingStats_init(TypingStats* stats);
+
+// Free the key buffer and the bigram history.
+void TypingStats_destroy(TypingStats* stats);
+
+// Start recording a round of length characters.
+void TypingStats_startRound(TypingStats* stats, size_t length);
+
+// Record a key press with a monotonic nanosecond timestamp and update the
+// bigram of the previous and the expected character.
+void TypingStats_recordKey(TypingStats* stats, uint64_t timestamp_ns, char expected, char typed, bool correct);
+
+// Merge the bigram history stored in the file. Returns false if it can't be read.
+bool TypingStats_load(TypingStats* stats, const char* file_path);
+
+// Store a bigram history to the file, replacing it atomically.
+bool TypingStats_saveBigrams(const BigramMatrix* bigrams, const char* file_path);
+
+// Log the slowest transitions of the history.
+void TypingStats_printSlowest(const TypingStats* stats, int n);
+
+#endif
@@ -1,5 +1,7 @@
 #include "window.h"
 
+#include "perf_stats.h"
+
 int Window_init(Window* window) {
     window->width = 1000;
     window->height = 1000;
@@ -13,6 +15,7 @@ int Window_init(Window* window) {
         return -1;
     }
     window->tooSmall = false;
+    window->vsync = false;
     return 0;
 }
 
@@ -37,15 +40,27 @@ void Window_resize(Window* window, SDL_Event e) {
     }
 }
 
+bool Window_setVSync(Window* window, bool enabled) {
+    if (!SDL_SetRenderVSync(window->renderer, enabled ? 1 : 0)) {
+        SDL_Log("Failed to set vsync: %s\n", SDL_GetError());
+        window->vsync = false;
+        return false;
+    }
+    window->vsync = enabled;
+    return enabled;
+}
+
 void Window_setColor(Window* win, SDL_Color color) {
     SDL_SetRenderDrawColor(win->renderer, color.r, color.g, color.b, color.a);
 }
 
 void Window_clear(Window* win) {
+    PerfStats_beginFrame(SDL_GetTicksNS());
     SDL_RenderClear(win->renderer);
 }
 
 void Window_render(Window* win) {
     SDL_RenderPresent(win->renderer);
+    PerfStats_endFrame(SDL_GetTicksNS());
 }
 
@@ -11,12 +11,16 @@ typedef struct {
     int width;
     int height;
     bool tooSmall;
+    // Whether presents are actually paced by vsync.
+    bool vsync;
 } Window;
 
 // Initialization and destruction.
 int Window_init(Window* window);
 void Window_destroy(Window* window);
 void Window_resize(Window* window, SDL_Event e);
+// Returns whether vsync is on afterwards, false if the renderer refused it.
+bool Window_setVSync(Window* window, bool enabled);
 
 // Rendering functions.
 void Window_clear(Window* win);
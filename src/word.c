@@ -1,122 +1,388 @@
 #include "word.h"
 
+#include "atomic_file.h"
+#include "log.h"
+
+#include <sys/stat.h>
+
+#include <stdio.h>
 #include <string.h>
-#include <time.h>
 #include <stdlib.h>
 
-int containsNonAscii(const char* word) {
-    while (*word) {
-        if ((unsigned char)(*word) > 127) {
+#define WORD_INDEX_MAGIC   "TTWIDX\0"
+#define WORD_INDEX_VERSION 2
+
+// Header of the dictionary index file. It's followed by the dictionary path
+// padded to 8 bytes, the offset table and the word blob.
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t path_length;
+    uint64_t dictionary_size;
+    int64_t dictionary_mtime;
+    uint32_t total_lines;
+    uint32_t blob_size;
+    uint32_t buckets[WORD_MAX_LENGTH + 1];
+    uint32_t reserved;
+} WordIndexHeader;
+
+static size_t paddedPathLength(size_t path_length) {
+    return (path_length + 7) & ~(size_t)7;
+}
+
+static int containsNonAscii(const char* word, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if ((unsigned char)word[i] > 127) {
             return 1;
         }
-        word++;
     }
     return 0;
 }
 
-void Word_init(Word* word, const char* dictionary_path) {
-    fflush(stdout);
-    word->total_lines = 0;
-    word->lines = NULL;
+// Length of the line without the trailing carriage return.
+static size_t lineLength(const char* line, const char* end) {
+    size_t length = end - line;
+    if (length > 0 && line[length - 1] == '\r') {
+        length--;
+    }
+    return length;
+}
 
-    // Open the dictionary file
-    FILE* file = fopen(dictionary_path, "r");
-    if (!file) {
-        fprintf(stderr, "Failed to open dictionary file in path %s\n", dictionary_path);
-        return;
+// Collect ASCII lines shorter than WORD_MAX_LENGTH and sort them into length buckets.
+static bool buildLines(Word* word) {
+    const char* data = word->file.data;
+    const char* data_end = data + word->file.size;
+
+    // Start from a guess of the line count and grow when needed.
+    size_t capacity = word->file.size / 8 + 16;
+    WordEntry* found = malloc(sizeof(WordEntry) * capacity);
+    if (!found) {
+        fprintf(stderr, "Memory allocation for lines array failed.\n");
+        return false;
     }
 
-    int line_count = 0;
-    char line[256];
+    uint32_t counts[WORD_MAX_LENGTH] = {0};
+    size_t total = 0;
+    const char* line = data;
+    while (line < data_end) {
+        const char* newline = memchr(line, '\n', data_end - line);
+        const char* line_end = newline ? newline : data_end;
+        size_t length = lineLength(line, line_end);
 
-    while (fgets(line, sizeof(line), file)) {
-        if (strlen(line) < 10) {
-            line_count++;
+        if (length > 0 && length < WORD_MAX_LENGTH && !containsNonAscii(line, length)) {
+            if (total >= capacity) {
+                capacity *= 2;
+                WordEntry* grown = realloc(found, sizeof(WordEntry) * capacity);
+                if (!grown) {
+                    fprintf(stderr, "Memory allocation for lines array failed.\n");
+                    free(found);
+                    return false;
+                }
+                found = grown;
+            }
+            found[total].offset = (uint32_t)(line - data);
+            found[total].length = (uint32_t)length;
+            counts[length]++;
+            total++;
         }
+        line = line_end + 1;
     }
 
-    // Allocate memory for lines array based on line_count
-    word->lines = malloc(sizeof(char*) * line_count);
-    if (!word->lines) {
+    // Counting sort by length, keeping dictionary order inside a bucket.
+    WordEntry* sorted = malloc(sizeof(WordEntry) * (total > 0 ? total : 1));
+    if (!sorted) {
         fprintf(stderr, "Memory allocation for lines array failed.\n");
-        fclose(file);
-        return;
+        free(found);
+        return false;
     }
 
-    // Reset the file pointer to the beginning
-    rewind(file);
+    uint32_t next[WORD_MAX_LENGTH];
+    uint32_t start = 0;
+    for (int length = 0; length < WORD_MAX_LENGTH; length++) {
+        word->buckets[length] = start;
+        next[length] = start;
+        start += counts[length];
+    }
+    word->buckets[WORD_MAX_LENGTH] = start;
 
-    // Second pass: Store lines shorter than 10 characters
-    int index = 0;
-    while (fgets(line, sizeof(line), file)) {
-        // Remove newline character
-        line[strcspn(line, "\n")] = '\0';
+    for (size_t i = 0; i < total; i++) {
+        sorted[next[found[i].length]++] = found[i];
+    }
+    free(found);
 
-        if (strlen(line) < 10) {
-            if (index >= line_count) {
-                break;
-            }
+    word->blob = data;
+    word->lines = sorted;
+    word->total_lines = (int)total;
+    word->owns_lines = true;
+    return true;
+}
 
-            word->lines[index] = strdup(line);
-            if (!word->lines[index]) {
-                fprintf(stderr, "Memory allocation for line %d failed.\n", index);
-                fclose(file);
-                return;
+// Check the offset table against the buckets and the blob, so a damaged
+// index can't make sentences read outside the mapping.
+static bool validIndex(const WordIndexHeader* header, const WordEntry* lines) {
+    if (header->buckets[0] != 0) {
+        return false;
+    }
+    for (int length = 0; length < WORD_MAX_LENGTH; length++) {
+        if (header->buckets[length] > header->buckets[length + 1]) {
+            return false;
+        }
+        for (uint32_t i = header->buckets[length]; i < header->buckets[length + 1]; i++) {
+            if (lines[i].length != (uint32_t)length ||
+                (uint64_t)lines[i].offset + lines[i].length > header->blob_size) {
+                return false;
             }
-            index++;
         }
     }
+    return true;
+}
+
+// Use the index file if it was built from the same dictionary.
+static bool loadIndex(Word* word, const char* index_path, const char* dictionary_path, const struct stat* st) {
+    if (!FileMap_open(&word->file, index_path)) {
+        return false;
+    }
+
+    const char* data = word->file.data;
+    size_t size = word->file.size;
+    size_t path_length = strlen(dictionary_path);
+
+    if (size < sizeof(WordIndexHeader)) {
+        FileMap_close(&word->file);
+        return false;
+    }
 
-    word->total_lines = line_count;
-    printf("Total lines in %s: %d\n", dictionary_path, word->total_lines);
-    fclose(file);
+    const WordIndexHeader* header = (const WordIndexHeader*)data;
+    size_t lines_offset = sizeof(WordIndexHeader) + paddedPathLength(header->path_length);
+    size_t blob_offset = lines_offset + (size_t)header->total_lines * sizeof(WordEntry);
+
+    if (memcmp(header->magic, WORD_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != WORD_INDEX_VERSION ||
+        header->path_length != path_length ||
+        header->dictionary_size != (uint64_t)st->st_size ||
+        header->dictionary_mtime != (int64_t)st->st_mtime ||
+        blob_offset + header->blob_size != size ||
+        header->buckets[WORD_MAX_LENGTH] != header->total_lines ||
+        memcmp(data + sizeof(WordIndexHeader), dictionary_path, path_length) != 0) {
+        FileMap_close(&word->file);
+        return false;
+    }
+    if (!validIndex(header, (const WordEntry*)(data + lines_offset))) {
+        LOG_WARN("Dictionary index %s is damaged, rebuilding it\n", index_path);
+        FileMap_close(&word->file);
+        return false;
+    }
+
+    memcpy(word->buckets, header->buckets, sizeof(word->buckets));
+    word->lines = (const WordEntry*)(data + lines_offset);
+    word->blob = data + blob_offset;
+    word->total_lines = (int)header->total_lines;
+    word->owns_lines = false;
+    return true;
 }
 
-void Word_destroy(Word* word) {
+// Write the parsed dictionary as an index file. The file is written under a
+// temporary name and renamed so a crash never leaves a partial index behind.
+static bool writeIndex(const Word* word, const char* index_path, const char* dictionary_path, const struct stat* st) {
+    char temp_path[512];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", index_path);
+
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        return false;
+    }
+
+    WordIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, WORD_INDEX_MAGIC, sizeof(header.magic));
+    header.version = WORD_INDEX_VERSION;
+    header.path_length = (uint32_t)strlen(dictionary_path);
+    header.dictionary_size = (uint64_t)st->st_size;
+    header.dictionary_mtime = (int64_t)st->st_mtime;
+    header.total_lines = (uint32_t)word->total_lines;
+    memcpy(header.buckets, word->buckets, sizeof(header.buckets));
     for (int i = 0; i < word->total_lines; i++) {
-        free(word->lines[i]);
+        header.blob_size += word->lines[i].length;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    char padding[8] = {0};
+    size_t padded = paddedPathLength(header.path_length);
+    ok = ok && fwrite(dictionary_path, 1, header.path_length, file) == header.path_length;
+    ok = ok && fwrite(padding, 1, padded - header.path_length, file) == padded - header.path_length;
+
+    // Offsets point into the packed blob written after the table.
+    uint32_t offset = 0;
+    for (int i = 0; ok && i < word->total_lines; i++) {
+        WordEntry entry = {offset, word->lines[i].length};
+        ok = fwrite(&entry, sizeof(entry), 1, file) == 1;
+        offset += entry.length;
+    }
+    for (int i = 0; ok && i < word->total_lines; i++) {
+        const WordEntry* entry = &word->lines[i];
+        ok = fwrite(word->blob + entry->offset, 1, entry->length, file) == entry->length;
+    }
+
+    if (fclose(file) != 0) {
+        ok = false;
     }
-    free(word->lines);
+    if (!ok || !AtomicFile_replace(temp_path, index_path)) {
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+void Word_init(Word* word, const char* dictionary_path, const char* index_path) {
+    word->total_lines = 0;
     word->lines = NULL;
+    word->blob = NULL;
+    word->owns_lines = false;
+    word->min_length = 1;
+    word->max_length = WORD_MAX_LENGTH - 1;
+    word->picks = NULL;
+    word->picks_capacity = 0;
+    memset(word->buckets, 0, sizeof(word->buckets));
+    memset(&word->file, 0, sizeof(word->file));
+
+    struct stat st;
+    if (stat(dictionary_path, &st) != 0) {
+        fprintf(stderr, "Failed to open dictionary file in path %s\n", dictionary_path);
+        return;
+    }
+
+    if (index_path && loadIndex(word, index_path, dictionary_path, &st)) {
+        LOG_INFO("Total lines in %s: %d (cached)\n", dictionary_path, word->total_lines);
+        return;
+    }
+
+    // Map the dictionary file
+    if (!FileMap_open(&word->file, dictionary_path)) {
+        fprintf(stderr, "Failed to open dictionary file in path %s\n", dictionary_path);
+        return;
+    }
+
+    if (!buildLines(word)) {
+        FileMap_close(&word->file);
+        return;
+    }
+
+    if (index_path && !writeIndex(word, index_path, dictionary_path, &st)) {
+        fprintf(stderr, "Failed to write dictionary index %s\n", index_path);
+    }
+
+    LOG_INFO("Total lines in %s: %d\n", dictionary_path, word->total_lines);
 }
 
-int randomLine(int max) {
-    return rand() % max;
+void Word_setLengthRange(Word* word, int min_length, int max_length) {
+    if (min_length < 1) {
+        min_length = 1;
+    }
+    // Both ends index the length buckets.
+    if (min_length > WORD_MAX_LENGTH - 1) {
+        min_length = WORD_MAX_LENGTH - 1;
+    }
+    if (max_length > WORD_MAX_LENGTH - 1) {
+        max_length = WORD_MAX_LENGTH - 1;
+    }
+    if (max_length < min_length) {
+        fprintf(stderr, "Invalid word length range %d-%d, using %d-%d\n", min_length, max_length, min_length, min_length);
+        max_length = min_length;
+    }
+    word->min_length = min_length;
+    word->max_length = max_length;
 }
 
-char* Word_getSentence(Word* word, int n) {
-    if (word->total_lines == 0) {
-        fprintf(stderr, "No lines available in Word structure.\n");
-        return NULL;
+void Word_destroy(Word* word) {
+    if (word->owns_lines) {
+        free((void*)word->lines);
     }
-    static char sentence[512];
-    sentence[0] = '\0';
+    free(word->picks);
+    word->picks = NULL;
+    word->picks_capacity = 0;
+    word->lines = NULL;
+    word->blob = NULL;
+    word->total_lines = 0;
+    word->owns_lines = false;
+    FileMap_close(&word->file);
+}
 
-    srand((unsigned) time(NULL));
+static bool isPicked(const uint32_t* picks, int count, uint32_t line) {
+    for (int i = 0; i < count; i++) {
+        if (picks[i] == line) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    int word_count = 0;
-    while (word_count < n) {
-        int random_index = randomLine(word->total_lines);
-        if (word->lines[random_index] == NULL) {
-            fprintf(stderr, "Null line encountered at index %d.\n", random_index);
-            continue;
+// Pick count distinct lines from [first, first + range) with Floyd's algorithm
+// and shuffle them, since Floyd's order is not uniform.
+static void pickDistinct(Random* random, uint32_t* picks, int count, uint32_t first, uint32_t range) {
+    int picked = 0;
+    for (uint32_t j = range - count; j < range; j++) {
+        uint32_t line = first + Random_bounded(random, j + 1);
+        if (isPicked(picks, picked, line)) {
+            line = first + j;
         }
+        picks[picked++] = line;
+    }
+
+    for (int i = count - 1; i > 0; i--) {
+        int k = (int)Random_bounded(random, (uint32_t)i + 1);
+        uint32_t temp = picks[i];
+        picks[i] = picks[k];
+        picks[k] = temp;
+    }
+}
+
+size_t Word_getSentence(Word* word, Random* random, int n, Sentence* sentence) {
+    Sentence_clear(sentence);
 
-        // Skip non-ASCII words
-        if (containsNonAscii(word->lines[random_index])) {
-            continue;
+    // Length buckets are contiguous, so the whole range is a single slice.
+    uint32_t first = word->buckets[word->min_length];
+    uint32_t range = word->buckets[word->max_length + 1] - first;
+
+    if (range == 0 || n <= 0) {
+        LOG_ERROR("No lines available in Word structure.\n");
+        return 0;
+    }
+    if (n > word->picks_capacity) {
+        uint32_t* picks = realloc(word->picks, sizeof(uint32_t) * n);
+        if (!picks) {
+            LOG_ERROR("Memory allocation for sentence failed.\n");
+            return 0;
         }
+        word->picks = picks;
+        word->picks_capacity = n;
+    }
+
+    // Repeat words only after every word in the range has been used.
+    for (int picked = 0; picked < n; picked += (int)range) {
+        int count = n - picked < (int)range ? n - picked : (int)range;
+        pickDistinct(random, word->picks + picked, count, first, range);
+    }
+
+    // Reserve the exact size up front: every word and the spaces between them.
+    size_t length = n - 1;
+    for (int i = 0; i < n; i++) {
+        length += word->lines[word->picks[i]].length;
+    }
+    if (!Sentence_reserve(sentence, length)) {
+        return 0;
+    }
 
-        // Concatenate word to sentence
-        strcat(sentence, word->lines[random_index]);
+    for (int word_count = 0; word_count < n; word_count++) {
+        const WordEntry* entry = &word->lines[word->picks[word_count]];
+        Sentence_append(sentence, word->blob + entry->offset, entry->length);
 
         // Add space if not the last word
         if (word_count < n - 1) {
-            strcat(sentence, " ");
+            Sentence_appendChar(sentence, ' ');
         }
-        word_count++;
     }
 
-    printf("Sentence: %s\n", sentence);
-    return sentence;
+    LOG_INFO("Sentence: %s\n", sentence->data);
+    return sentence->length;
 }
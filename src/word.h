@@ -1,21 +1,61 @@
 #ifndef WORD_H
 #define WORD_H
 
-#include <stdio.h>
+#include "file_map.h"
+#include "random.h"
+#include "sentence.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Words of this length or longer are not used.
+#define WORD_MAX_LENGTH 10
+
+// Location of a single word inside the word blob.
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+} WordEntry;
 
 typedef struct {
-    char** lines;
+    // Dictionary or index file mapped into memory.
+    FileMap file;
+
+    // Characters of the words, either the dictionary itself or the index blob.
+    const char* blob;
+
+    // Offset table of the ASCII words, sorted by word length.
+    const WordEntry* lines;
     int total_lines;
-    FILE* file;
+
+    // First line of each word length, buckets[WORD_MAX_LENGTH] is the total.
+    uint32_t buckets[WORD_MAX_LENGTH + 1];
+
+    // Offset table is allocated instead of pointing into the index file.
+    bool owns_lines;
+
+    // Word lengths used for sentences.
+    int min_length;
+    int max_length;
+
+    // Scratch space for the picked lines of a sentence.
+    uint32_t* picks;
+    int picks_capacity;
 } Word;
 
-// Allocate dictionary context.
-void Word_init(Word* word, const char* dictionary_path);
+// Allocate dictionary context. The index file is used as a cache of the parsed
+// dictionary when index_path is not NULL.
+void Word_init(Word* word, const char* dictionary_path, const char* index_path);
+
+// Limit sentences to words of min_length to max_length letters.
+void Word_setLengthRange(Word* word, int min_length, int max_length);
 
 // Deallocate dictionary context.
 void Word_destroy(Word* word);
 
-// Get random sentence from the dictionary file.
-char* Word_getSentence(Word* word, int n);
+// Write a random sentence of n words into the sentence buffer, replacing its
+// contents. Words are not repeated unless there are fewer usable words than n.
+// Returns the sentence length, 0 if no words are available.
+size_t Word_getSentence(Word* word, Random* random, int n, Sentence* sentence);
 
 #endif
@@ -0,0 +1,303 @@
+#include "game_core.h"
+#include "word.h"
+#include "random.h"
+#include "sentence.h"
+#include "log.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Replays keystroke streams through the game core without a window.
+//
+// Synthetic streams type sentences from the dictionary with a seeded random
+// generator, so the same options always produce the same results. Recorded
+// streams are text files of
+//
+//     round <timestamp_ns> <sentence>
+//     key <timestamp_ns> <keycode>
+//
+// lines, where keycode is the ASCII code or 65536 for a shift press.
+//
+// With --expect_wpm and --expect_accuracy the averages are checked and the
+// exit status is 1 if they differ.
+
+typedef struct {
+    const char* dictionary;
+    const char* keys_file;
+    int total_words;
+    int rounds;
+    uint64_t seed;
+    double error_rate;
+    bool advance_on_failure;
+    // NAN when not checked.
+    double expect_wpm;
+    double expect_accuracy;
+} ReplayOptions;
+
+typedef struct {
+    uint64_t rounds;
+    uint64_t keys;
+    double wpm;
+    double accuracy;
+} ReplayResult;
+
+typedef struct {
+    uint64_t timestamp_ns;
+    int keycode;
+    // Index into the sentence buffer for "round" lines, -1 for keys.
+    long round_offset;
+} ReplayEvent;
+
+static double nowSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static void finishRound(const GameCore* core, ReplayResult* result) {
+    result->rounds++;
+    result->wpm += GameCore_wpm(core);
+    result->accuracy += GameCore_accuracy(core);
+}
+
+static bool appendEvent(ReplayEvent** events, size_t* count, size_t* capacity, ReplayEvent event) {
+    if (*count == *capacity) {
+        size_t grown_capacity = *capacity > 0 ? *capacity * 2 : 1024;
+        ReplayEvent* grown = realloc(*events, sizeof(ReplayEvent) * grown_capacity);
+        if (!grown) {
+            fprintf(stderr, "Memory allocation for replay events failed.\n");
+            return false;
+        }
+        *events = grown;
+        *capacity = grown_capacity;
+    }
+    (*events)[(*count)++] = event;
+    return true;
+}
+
+static bool appendRound(ReplayEvent** events, size_t* count, size_t* capacity, Sentence* sentences,
+                        uint64_t timestamp_ns, const char* text, size_t length) {
+    ReplayEvent event = {timestamp_ns, 0, (long)sentences->length};
+    return Sentence_append(sentences, text, length) && Sentence_appendChar(sentences, '\0') &&
+           appendEvent(events, count, capacity, event);
+}
+
+// Type every sentence with key intervals of 80-200 ms and a wrong key at
+// error_rate, pressing shift for capitals. The keys are recorded as events,
+// with a core following along to know the next expected character.
+static bool generateSynthetic(const ReplayOptions* options, ReplayEvent** events, size_t* count, Sentence* sentences) {
+    Word word;
+    Word_init(&word, options->dictionary, NULL);
+    if (word.total_lines == 0) {
+        fprintf(stderr, "No words in %s\n", options->dictionary);
+        Word_destroy(&word);
+        return false;
+    }
+
+    GameCore core;
+    GameCore_init(&core, options->total_words, options->advance_on_failure, NULL);
+    Random random;
+    Random_init(&random, options->seed);
+    Sentence sentence;
+    Sentence_init(&sentence);
+    uint32_t error_threshold = (uint32_t)(options->error_rate * 1000000.0);
+    uint64_t timestamp = 0;
+    size_t capacity = 0;
+    bool ok = true;
+
+    for (int round = 0; ok && round < options->rounds; round++) {
+        if (Word_getSentence(&word, &random, options->total_words, &sentence) == 0) {
+            break;
+        }
+        GameCore_startRound(&core, sentence.data, sentence.length, timestamp);
+        ok = appendRound(events, count, &capacity, sentences, timestamp, sentence.data, sentence.length);
+
+        while (ok && !GameCore_finished(&core)) {
+            char expected = sentence.data[core.checkIndex];
+            int key = tolower((unsigned char)expected);
+            if (Random_bounded(&random, 1000000) < error_threshold) {
+                key = key == 'x' ? 'z' : 'x';
+            } else if (isupper((unsigned char)expected)) {
+                GameCore_feedKey(&core, timestamp, GAME_CORE_KEY_SHIFT);
+                ok = appendEvent(events, count, &capacity, (ReplayEvent){timestamp, GAME_CORE_KEY_SHIFT, -1});
+            }
+            timestamp += 80000000 + (uint64_t)Random_bounded(&random, 120000000);
+            GameCore_feedKey(&core, timestamp, key);
+            ok = ok && appendEvent(events, count, &capacity, (ReplayEvent){timestamp, key, -1});
+        }
+    }
+
+    Sentence_destroy(&sentence);
+    Word_destroy(&word);
+    return ok;
+}
+
+// Read the whole recording first so parsing isn't part of the replay time.
+static bool loadRecording(const char* file_path, ReplayEvent** events, size_t* count, Sentence* sentences) {
+    FILE* file = fopen(file_path, "r");
+    if (!file) {
+        perror("Failed to open key file");
+        return false;
+    }
+
+    size_t capacity = 0;
+    char line[4096];
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        unsigned long long timestamp;
+        int keycode;
+        int text_start = 0;
+
+        if (sscanf(line, "round %llu %n", &timestamp, &text_start) == 1 && text_start > 0) {
+            const char* text = line + text_start;
+            ok = appendRound(events, count, &capacity, sentences, timestamp, text, strlen(text));
+        } else if (sscanf(line, "key %llu %d", &timestamp, &keycode) == 2) {
+            ok = appendEvent(events, count, &capacity, (ReplayEvent){timestamp, keycode, -1});
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+// Feed the events through the core. Only this loop is timed.
+static void replayEvents(const ReplayEvent* events, size_t count, const Sentence* sentences, GameCore* core,
+                         ReplayResult* result, double* elapsed) {
+    double start = nowSeconds();
+    for (size_t i = 0; i < count; i++) {
+        const ReplayEvent* event = &events[i];
+        if (event->round_offset >= 0) {
+            const char* text = sentences->data + event->round_offset;
+            GameCore_startRound(core, text, strlen(text), event->timestamp_ns);
+        } else if (core->text &&
+                   GameCore_feedKey(core, event->timestamp_ns, event->keycode) != GAME_CORE_KEY_IGNORED) {
+            result->keys++;
+            if (GameCore_finished(core)) {
+                finishRound(core, result);
+            }
+        }
+    }
+    *elapsed = nowSeconds() - start;
+}
+
+// Compare a result against an expected value given on the command line.
+static bool checkExpected(const char* name, double actual, double expected) {
+    if (isnan(expected)) {
+        return true;
+    }
+    if (fabs(actual - expected) > 1e-4 * fmax(1.0, fabs(expected))) {
+        fprintf(stderr, "Expected %s %.6f, got %.6f\n", name, expected, actual);
+        return false;
+    }
+    return true;
+}
+
+static const char* optionValue(int argc, char** argv, int* i) {
+    const char* equals = strchr(argv[*i], '=');
+    if (equals) {
+        return equals + 1;
+    }
+    return *i + 1 < argc ? argv[++*i] : NULL;
+}
+
+static bool optionIs(const char* arg, const char* name) {
+    size_t length = strlen(name);
+    return strncmp(arg, name, length) == 0 && (arg[length] == '\0' || arg[length] == '=');
+}
+
+static bool parseOptions(ReplayOptions* options, int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (optionIs(arg, "--advance_on_failure")) {
+            options->advance_on_failure = true;
+            continue;
+        }
+
+        const char* value = optionValue(argc, argv, &i);
+        if (!value) {
+            fprintf(stderr, "Missing value for %s\n", arg);
+            return false;
+        }
+        if (optionIs(arg, "--dictionary")) {
+            options->dictionary = value;
+        } else if (optionIs(arg, "--keys")) {
+            options->keys_file = value;
+        } else if (optionIs(arg, "--total_words")) {
+            options->total_words = atoi(value);
+        } else if (optionIs(arg, "--rounds")) {
+            options->rounds = atoi(value);
+        } else if (optionIs(arg, "--seed")) {
+            options->seed = strtoull(value, NULL, 10);
+        } else if (optionIs(arg, "--error_rate")) {
+            options->error_rate = atof(value);
+        } else if (optionIs(arg, "--expect_wpm")) {
+            options->expect_wpm = atof(value);
+        } else if (optionIs(arg, "--expect_accuracy")) {
+            options->expect_accuracy = atof(value);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    ReplayOptions options = {
+        .dictionary = "/usr/share/dict/american-english",
+        .keys_file = NULL,
+        .total_words = 25,
+        .rounds = 10000,
+        .seed = 1,
+        .error_rate = 0.03,
+        .advance_on_failure = false,
+        .expect_wpm = NAN,
+        .expect_accuracy = NAN,
+    };
+    if (!parseOptions(&options, argc, argv)) {
+        fprintf(stderr, "Usage: replay [--keys file] [--dictionary path] [--total_words n] [--rounds n] "
+                        "[--seed n] [--error_rate p] [--advance_on_failure] [--expect_wpm v] [--expect_accuracy v]\n");
+        return 1;
+    }
+
+    Log_init();
+
+    ReplayEvent* events = NULL;
+    size_t count = 0;
+    Sentence sentences;
+    Sentence_init(&sentences);
+    bool ok = options.keys_file ? loadRecording(options.keys_file, &events, &count, &sentences)
+                                : generateSynthetic(&options, &events, &count, &sentences);
+
+    GameCore core;
+    GameCore_init(&core, options.total_words, options.advance_on_failure, NULL);
+    ReplayResult result = {0, 0, 0.0, 0.0};
+    double elapsed = 0.0;
+    if (ok) {
+        replayEvents(events, count, &sentences, &core, &result, &elapsed);
+    }
+
+    free(events);
+    Sentence_destroy(&sentences);
+    Log_quit();
+
+    if (!ok) {
+        return 1;
+    }
+
+    double rounds = result.rounds > 0 ? (double)result.rounds : 1.0;
+    printf("rounds: %llu\n", (unsigned long long)result.rounds);
+    printf("keys: %llu\n", (unsigned long long)result.keys);
+    printf("average speed: %.6f WPM\n", result.wpm / rounds);
+    printf("average accuracy: %.6f %%\n", result.accuracy / rounds);
+    printf("time: %.3f s (%.0f keys/s)\n", elapsed, elapsed > 0.0 ? result.keys / elapsed : 0.0);
+
+    bool expected = checkExpected("speed", result.wpm / rounds, options.expect_wpm);
+    expected = checkExpected("accuracy", result.accuracy / rounds, options.expect_accuracy) && expected;
+    return expected ? 0 : 1;
+}